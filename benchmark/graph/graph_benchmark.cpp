@@ -0,0 +1,1355 @@
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <execution>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <map>
+#include <memory_resource>
+#include <mutex>
+#include <new>
+#include <queue>
+#include <random>
+#include <set>
+#include <shared_mutex>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gdwg/concurrent_graph.hpp"
+#include "gdwg/csr_graph.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/mapped_graph.hpp"
+#include "gdwg/parallel_graph.hpp"
+#include "gdwg/parallel_traversal.hpp"
+#include "gdwg/shortest_paths.hpp"
+#include "gdwg/text_format.hpp"
+#include "gdwg/traversal.hpp"
+
+#include <benchmark/benchmark.h>
+#include <fcntl.h>
+#include <tbb/global_control.h>
+#include <unistd.h>
+
+// Every benchmark is registered once per graph shape and is run over graphs holding 1e3 to 1e6
+// edges, so that the reported complexity is the one of the shape rather than a mix of them.
+namespace {
+	using graph = gdwg::graph<int, int>;
+	using csr_graph = gdwg::csr_graph<int, int>;
+	using flat_graph = gdwg::graph<int, int, gdwg::flat_storage>;
+	using chunked_graph = gdwg::graph<int, int, gdwg::chunked_storage>;
+	using concurrent_graph = gdwg::concurrent_graph<int, int>;
+	using mapped_graph = gdwg::mapped_graph<int, int>;
+
+	// Counts every call to the global operator new below.
+	auto allocations = std::atomic<std::int64_t>{0};
+
+	enum class shape { sparse, dense, power_law };
+
+	constexpr auto min_edges = std::int64_t{1'000};
+	constexpr auto max_edges = std::int64_t{1'000'000};
+
+	// Keeps the edge list of every generated graph, because building a graph of a million edges
+	// is far more expensive than most of the operations measured on it.
+	struct fixture {
+		std::vector<graph::value_type> edges;
+		std::vector<int> nodes;
+		graph g;
+		csr_graph csr; // the same graph, frozen
+		flat_graph flat; // the same graph, stored in sorted vectors
+		graph positive; // the same graph with every weight made non-negative, for dijkstra
+	};
+
+	auto node_count(shape s, std::int64_t edges) -> int {
+		switch (s) {
+		case shape::sparse: return static_cast<int>(std::max<std::int64_t>(edges / 4, 2));
+		case shape::dense:
+			return static_cast<int>(std::ceil(std::sqrt(static_cast<double>(edges))));
+		case shape::power_law: return static_cast<int>(std::max<std::int64_t>(edges / 8, 2));
+		}
+		return 2;
+	}
+
+	// sparse:    every node has an out-degree of about four, endpoints are uniformly distributed.
+	// dense:     sqrt(e) nodes, each connected to (almost) every other node.
+	// power_law: sources are drawn from a heavily skewed distribution, so a few hubs own most of
+	//            the edges, and destinations are uniformly distributed.
+	auto make_edges(shape s, std::int64_t edges) -> std::vector<graph::value_type> {
+		auto const n = node_count(s, edges);
+		auto engine = std::mt19937_64{6771};
+		auto uniform_node = std::uniform_int_distribution<int>{0, n - 1};
+		auto weight = std::uniform_int_distribution<int>{-100, 100};
+		auto unit = std::uniform_real_distribution<double>{0.0, 1.0};
+		auto result = std::vector<graph::value_type>{};
+		result.reserve(static_cast<std::size_t>(edges));
+		for (auto i = std::int64_t{0}; i < edges; ++i) {
+			switch (s) {
+			case shape::sparse:
+				result.push_back({uniform_node(engine), uniform_node(engine), weight(engine)});
+				break;
+			case shape::dense:
+				result.push_back({static_cast<int>(i / n), static_cast<int>(i % n), weight(engine)});
+				break;
+			case shape::power_law: {
+				auto const src = static_cast<int>(static_cast<double>(n) * std::pow(unit(engine), 3.0));
+				result.push_back({std::min(src, n - 1), uniform_node(engine), weight(engine)});
+				break;
+			}
+			}
+		}
+		return result;
+	}
+
+	// The same edges, as the value_type of a graph with another storage policy.
+	template<typename G>
+	auto edges_for(std::vector<graph::value_type> const& edges)
+	   -> std::vector<typename G::value_type> {
+		auto result = std::vector<typename G::value_type>{};
+		result.reserve(edges.size());
+		for (auto const& [from, to, weight] : edges) {
+			result.push_back({from, to, weight});
+		}
+		return result;
+	}
+
+	auto get_fixture(shape s, std::int64_t edges) -> fixture const& {
+		static auto cache = std::map<std::pair<shape, std::int64_t>, fixture>{};
+		auto const key = std::pair{s, edges};
+		if (auto const found = cache.find(key); found != cache.end()) {
+			return found->second;
+		}
+		auto f = fixture{};
+		f.edges = make_edges(s, edges);
+		f.g = graph(f.edges.begin(), f.edges.end());
+		for (auto i = 0; i < node_count(s, edges); ++i) {
+			f.g.insert_node(i); // nodes without any edge are still part of the graph
+		}
+		f.nodes = f.g.nodes();
+		f.csr = csr_graph(f.g);
+		auto const flat_edges = edges_for<flat_graph>(f.edges);
+		f.flat = flat_graph(flat_edges.begin(), flat_edges.end());
+		for (auto const& node : f.nodes) {
+			f.flat.insert_node(node);
+		}
+		auto positive_edges = f.edges;
+		for (auto& edge : positive_edges) {
+			edge.weight = std::abs(edge.weight);
+		}
+		f.positive = graph(positive_edges.begin(), positive_edges.end());
+		for (auto const& node : f.nodes) {
+			f.positive.insert_node(node);
+		}
+		return cache.emplace(key, std::move(f)).first->second;
+	}
+
+	// Returns `count` elements of `from`, picked at random but reproducibly.
+	template<typename T>
+	auto sample(std::vector<T> const& from, std::size_t count) -> std::vector<T> {
+		auto engine = std::mt19937_64{count};
+		auto pick = std::uniform_int_distribution<std::size_t>{0, from.size() - 1};
+		auto result = std::vector<T>{};
+		result.reserve(count);
+		for (auto i = std::size_t{0}; i < count; ++i) {
+			result.push_back(from[pick(engine)]);
+		}
+		return result;
+	}
+
+	constexpr auto sample_size = std::size_t{1024};
+
+	auto finish(benchmark::State& state, std::int64_t edges) -> void {
+		state.SetComplexityN(edges);
+		state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()));
+	}
+
+	// Reports the heap allocations made per iteration, leaving out those made while the timer is
+	// paused to reset the graph.
+	class allocation_meter {
+	public:
+		auto pause() noexcept -> void {
+			paused_at_ = allocations.load(std::memory_order_relaxed);
+		}
+		auto resume() noexcept -> void {
+			skipped_ += allocations.load(std::memory_order_relaxed) - paused_at_;
+		}
+		auto report(benchmark::State& state) const -> void {
+			auto const made = allocations.load(std::memory_order_relaxed) - start_ - skipped_;
+			state.counters["allocs_per_op"] =
+			   benchmark::Counter(static_cast<double>(made), benchmark::Counter::kAvgIterations);
+		}
+
+	private:
+		std::int64_t start_ = allocations.load(std::memory_order_relaxed);
+		std::int64_t paused_at_ = 0;
+		std::int64_t skipped_ = 0;
+	};
+
+	// Modifiers
+
+	auto bm_insert_node(benchmark::State& state, shape s) -> void {
+		auto const& f = get_fixture(s, state.range(0));
+		auto g = f.g;
+		auto next = static_cast<int>(f.nodes.size());
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(g.insert_node(next++));
+		}
+		finish(state, state.range(0));
+	}
+
+	auto bm_insert_edge(benchmark::State& state, shape s) -> void {
+		auto const& f = get_fixture(s, state.range(0));
+		auto g = f.g;
+		auto const srcs = sample(f.nodes, sample_size);
+		auto const dsts = sample(f.nodes, sample_size + 1);
+		auto i = std::size_t{0};
+		auto weight = 1000; // out of the range used by make_edges, so every insertion is new
+		auto const meter = allocation_meter{};
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(g.insert_edge(srcs[i], dsts[i], weight));
+			if (++i == sample_size) {
+				i = 0;
+				++weight;
+			}
+		}
+		meter.report(state);
+		finish(state, state.range(0));
+	}
+
+	auto bm_erase_node(benchmark::State& state, shape s) -> void {
+		auto const& f = get_fixture(s, state.range(0));
+		auto g = f.g;
+		auto const victims = sample(f.nodes, std::min(sample_size, f.nodes.size()));
+		auto next = victims.begin();
+		for (auto _ : state) {
+			if (next == victims.end()) {
+				state.PauseTiming();
+				g = graph(f.g);
+				next = victims.begin();
+				state.ResumeTiming();
+			}
+			benchmark::DoNotOptimize(g.erase_node(*next++));
+		}
+		finish(state, state.range(0));
+	}
+
+	auto bm_erase_edge(benchmark::State& state, shape s) -> void {
+		auto const& f = get_fixture(s, state.range(0));
+		auto g = f.g;
+		auto const victims = sample(f.edges, sample_size);
+		auto next = victims.begin();
+		auto meter = allocation_meter{};
+		for (auto _ : state) {
+			if (next == victims.end()) {
+				state.PauseTiming();
+				meter.pause();
+				g = graph(f.g);
+				next = victims.begin();
+				meter.resume();
+				state.ResumeTiming();
+			}
+			benchmark::DoNotOptimize(g.erase_edge(next->from, next->to, next->weight));
+			++next;
+		}
+		meter.report(state);
+		finish(state, state.range(0));
+	}
+
+	auto bm_replace_node(benchmark::State& state, shape s) -> void {
+		auto const& f = get_fixture(s, state.range(0));
+		auto g = f.g;
+		auto const victims = sample(f.nodes, std::min(sample_size, f.nodes.size()));
+		auto next = victims.begin();
+		auto fresh = static_cast<int>(f.nodes.size());
+		for (auto _ : state) {
+			if (next == victims.end()) {
+				state.PauseTiming();
+				g = graph(f.g);
+				next = victims.begin();
+				fresh = static_cast<int>(f.nodes.size());
+				state.ResumeTiming();
+			}
+			// a renamed node is never picked again before the graph is reset, but a node that was
+			// sampled twice is, so replace_node legitimately throws for it
+			if (g.is_node(*next)) {
+				benchmark::DoNotOptimize(g.replace_node(*next, fresh++));
+			}
+			++next;
+		}
+		finish(state, state.range(0));
+	}
+
+	auto bm_merge_replace_node(benchmark::State& state, shape s) -> void {
+		auto const& f = get_fixture(s, state.range(0));
+		auto g = f.g;
+		auto const olds = sample(f.nodes, std::min(sample_size, f.nodes.size()));
+		auto const news = sample(f.nodes, std::min(sample_size, f.nodes.size()) + 1);
+		auto i = std::size_t{0};
+		for (auto _ : state) {
+			if (i == olds.size()) {
+				state.PauseTiming();
+				g = graph(f.g);
+				i = 0;
+				state.ResumeTiming();
+			}
+			if (olds[i] != news[i] and g.is_node(olds[i]) and g.is_node(news[i])) {
+				g.merge_replace_node(olds[i], news[i]);
+			}
+			++i;
+		}
+		finish(state, state.range(0));
+	}
+
+	// Batch modifiers, SetItemsProcessed counts the elements of the batches
+
+	auto bm_insert_edges(benchmark::State& state, shape s) -> void {
+		auto const& f = get_fixture(s, state.range(0));
+		auto g = f.g;
+		auto batch = sample(f.edges, sample_size);
+		for (auto& i : batch) {
+			i.weight = 1000; // out of the range used by make_edges, so every insertion is new
+		}
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(g.insert_edges(batch.begin(), batch.end()));
+			for (auto& i : batch) {
+				++i.weight;
+			}
+		}
+		state.SetComplexityN(state.range(0));
+		state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations())
+		                        * static_cast<std::int64_t>(sample_size));
+	}
+
+	auto bm_erase_nodes(benchmark::State& state, shape s) -> void {
+		auto const& f = get_fixture(s, state.range(0));
+		auto g = f.g;
+		auto const victims = sample(f.nodes, f.nodes.size() / 16 + 1);
+		for (auto _ : state) {
+			state.PauseTiming();
+			g = graph(f.g);
+			state.ResumeTiming();
+			benchmark::DoNotOptimize(g.erase_nodes(victims.begin(), victims.end()));
+		}
+		state.SetComplexityN(state.range(0));
+		state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations())
+		                        * static_cast<std::int64_t>(victims.size()));
+	}
+
+	// Accessors
+
+	auto bm_is_connected(benchmark::State& state, shape s) -> void {
+		auto const& f = get_fixture(s, state.range(0));
+		auto const srcs = sample(f.nodes, sample_size);
+		auto const dsts = sample(f.nodes, sample_size + 1);
+		auto i = std::size_t{0};
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(f.g.is_connected(srcs[i], dsts[i]));
+			i = (i + 1) % sample_size;
+		}
+		finish(state, state.range(0));
+	}
+
+	auto bm_weights(benchmark::State& state, shape s) -> void {
+		auto const& f = get_fixture(s, state.range(0));
+		auto const probes = sample(f.edges, sample_size);
+		auto i = std::size_t{0};
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(f.g.weights(probes[i].from, probes[i].to));
+			i = (i + 1) % sample_size;
+		}
+		finish(state, state.range(0));
+	}
+
+	auto bm_connections(benchmark::State& state, shape s) -> void {
+		auto const& f = get_fixture(s, state.range(0));
+		auto const probes = sample(f.edges, sample_size); // sources that have outgoing edges
+		auto i = std::size_t{0};
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(f.g.connections(probes[i].from));
+			i = (i + 1) % sample_size;
+		}
+		finish(state, state.range(0));
+	}
+
+	// nodes and weights against their views, reporting the allocations each of them makes
+	auto bm_nodes(benchmark::State& state, shape s) -> void {
+		auto const& f = get_fixture(s, state.range(0));
+		auto const meter = allocation_meter{};
+		for (auto _ : state) {
+			auto sum = 0L;
+			for (auto const& node : f.g.nodes()) {
+				sum += node;
+			}
+			benchmark::DoNotOptimize(sum);
+		}
+		meter.report(state);
+		finish(state, state.range(0));
+	}
+
+	auto bm_nodes_view(benchmark::State& state, shape s) -> void {
+		auto const& f = get_fixture(s, state.range(0));
+		auto const meter = allocation_meter{};
+		for (auto _ : state) {
+			auto sum = 0L;
+			for (auto const& node : f.g.nodes_view()) {
+				sum += node;
+			}
+			benchmark::DoNotOptimize(sum);
+		}
+		meter.report(state);
+		finish(state, state.range(0));
+	}
+
+	auto bm_weights_view(benchmark::State& state, shape s) -> void {
+		auto const& f = get_fixture(s, state.range(0));
+		auto const probes = sample(f.edges, sample_size);
+		auto const meter = allocation_meter{};
+		auto i = std::size_t{0};
+		for (auto _ : state) {
+			auto sum = 0L;
+			for (auto const& weight : f.g.weights_view(probes[i].from, probes[i].to)) {
+				sum += weight;
+			}
+			benchmark::DoNotOptimize(sum);
+			i = (i + 1) % sample_size;
+		}
+		meter.report(state);
+		finish(state, state.range(0));
+	}
+
+	auto bm_out_edges(benchmark::State& state, shape s) -> void {
+		auto const& f = get_fixture(s, state.range(0));
+		auto const probes = sample(f.edges, sample_size);
+		auto const meter = allocation_meter{};
+		auto i = std::size_t{0};
+		for (auto _ : state) {
+			auto sum = 0L;
+			for (auto const& [from, to, weight] : f.g.out_edges(probes[i].from)) {
+				sum += to + weight;
+			}
+			benchmark::DoNotOptimize(sum);
+			i = (i + 1) % sample_size;
+		}
+		meter.report(state);
+		finish(state, state.range(0));
+	}
+
+	auto bm_predecessors(benchmark::State& state, shape s) -> void {
+		auto const& f = get_fixture(s, state.range(0));
+		auto const probes = sample(f.edges, sample_size); // destinations that have incoming edges
+		auto i = std::size_t{0};
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(f.g.predecessors(probes[i].to));
+			i = (i + 1) % sample_size;
+		}
+		finish(state, state.range(0));
+	}
+
+	// What predecessors replaces: a walk over every edge.
+	auto bm_predecessors_by_scan(benchmark::State& state, shape s) -> void {
+		auto const& f = get_fixture(s, state.range(0));
+		auto const probes = sample(f.edges, sample_size);
+		auto i = std::size_t{0};
+		for (auto _ : state) {
+			auto vec = std::vector<int>{};
+			for (auto const& [from, to, weight] : f.g) {
+				if (to == probes[i].to and (vec.empty() or vec.back() != from)) {
+					vec.push_back(from);
+				}
+			}
+			benchmark::DoNotOptimize(vec);
+			i = (i + 1) % sample_size;
+		}
+		finish(state, state.range(0));
+	}
+
+	auto bm_in_degree(benchmark::State& state, shape s) -> void {
+		auto const& f = get_fixture(s, state.range(0));
+		auto const probes = sample(f.edges, sample_size);
+		auto i = std::size_t{0};
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(f.g.in_degree(probes[i].to));
+			i = (i + 1) % sample_size;
+		}
+		finish(state, state.range(0));
+	}
+
+	// What in_degree did before it kept count: a walk over the incoming edges.
+	auto bm_in_degree_by_walk(benchmark::State& state, shape s) -> void {
+		auto const& f = get_fixture(s, state.range(0));
+		auto const probes = sample(f.edges, sample_size);
+		auto i = std::size_t{0};
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(f.g.in_edges(probes[i].to).size());
+			i = (i + 1) % sample_size;
+		}
+		finish(state, state.range(0));
+	}
+
+	auto bm_out_degree(benchmark::State& state, shape s) -> void {
+		auto const& f = get_fixture(s, state.range(0));
+		auto const probes = sample(f.edges, sample_size);
+		auto i = std::size_t{0};
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(f.g.out_degree(probes[i].from));
+			i = (i + 1) % sample_size;
+		}
+		finish(state, state.range(0));
+	}
+
+	auto bm_edge_count(benchmark::State& state, shape s) -> void {
+		auto const& f = get_fixture(s, state.range(0));
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(f.g.edge_count());
+		}
+		finish(state, state.range(0));
+	}
+
+	// What edge_count replaces: a walk over every edge.
+	auto bm_edge_count_by_walk(benchmark::State& state, shape s) -> void {
+		auto const& f = get_fixture(s, state.range(0));
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(std::distance(f.g.begin(), f.g.end()));
+		}
+		finish(state, state.range(0));
+	}
+
+	auto bm_connections_view(benchmark::State& state, shape s) -> void {
+		auto const& f = get_fixture(s, state.range(0));
+		auto const probes = sample(f.edges, sample_size);
+		auto i = std::size_t{0};
+		for (auto _ : state) {
+			auto sum = 0L;
+			for (auto const& dst : f.g.connections_view(probes[i].from)) {
+				sum += dst;
+			}
+			benchmark::DoNotOptimize(sum);
+			i = (i + 1) % sample_size;
+		}
+		finish(state, state.range(0));
+	}
+
+	auto bm_find(benchmark::State& state, shape s) -> void {
+		auto const& f = get_fixture(s, state.range(0));
+		auto const probes = sample(f.edges, sample_size);
+		auto i = std::size_t{0};
+		auto const meter = allocation_meter{};
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(f.g.find(probes[i].from, probes[i].to, probes[i].weight));
+			i = (i + 1) % sample_size;
+		}
+		meter.report(state);
+		finish(state, state.range(0));
+	}
+
+	auto bm_construct(benchmark::State& state, shape s) -> void {
+		auto const& f = get_fixture(s, state.range(0));
+		for (auto _ : state) {
+			auto g = graph(f.edges.begin(), f.edges.end());
+			benchmark::DoNotOptimize(g);
+		}
+		finish(state, state.range(0));
+	}
+
+	auto bm_construct_parallel(benchmark::State& state, shape s) -> void {
+		auto const& f = get_fixture(s, state.range(0));
+		for (auto _ : state) {
+			auto g =
+			   gdwg::build_graph<int, int>(std::execution::par_unseq, f.edges.begin(), f.edges.end());
+			benchmark::DoNotOptimize(g);
+		}
+		finish(state, state.range(0));
+	}
+
+	// build_graph on a million sparse edges, run on state.range(0) threads at most.
+	auto bm_construct_threads(benchmark::State& state) -> void {
+		auto const& f = get_fixture(shape::sparse, max_edges);
+		auto const threads = static_cast<std::size_t>(state.range(0));
+		auto const limit =
+		   tbb::global_control(tbb::global_control::max_allowed_parallelism, threads);
+		for (auto _ : state) {
+			auto g =
+			   gdwg::build_graph<int, int>(std::execution::par_unseq, f.edges.begin(), f.edges.end());
+			benchmark::DoNotOptimize(g);
+		}
+		state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) * max_edges);
+	}
+
+	// A scratch graph is built and dropped on every iteration, with everything allocated from the
+	// default heap or from a monotonic arena that is released at once.
+	auto bm_scratch_heap(benchmark::State& state, shape s) -> void {
+		auto const& f = get_fixture(s, state.range(0));
+		auto const meter = allocation_meter{};
+		for (auto _ : state) {
+			auto g = graph(f.edges.begin(), f.edges.end(), std::pmr::new_delete_resource());
+			benchmark::DoNotOptimize(g);
+		}
+		meter.report(state);
+		finish(state, state.range(0));
+	}
+
+	auto bm_scratch_arena(benchmark::State& state, shape s) -> void {
+		auto const& f = get_fixture(s, state.range(0));
+		auto const meter = allocation_meter{};
+		for (auto _ : state) {
+			auto arena = std::pmr::monotonic_buffer_resource();
+			auto g = graph(f.edges.begin(), f.edges.end(), &arena);
+			benchmark::DoNotOptimize(g);
+		}
+		meter.report(state);
+		finish(state, state.range(0));
+	}
+
+	auto bm_copy(benchmark::State& state, shape s) -> void {
+		auto const& f = get_fixture(s, state.range(0));
+		for (auto _ : state) {
+			auto copy = f.g;
+			benchmark::DoNotOptimize(copy);
+		}
+		finish(state, state.range(0));
+	}
+
+	// Two graphs built alike, so their nodes have the same ids.
+	auto bm_equal(benchmark::State& state, shape s) -> void {
+		auto const& f = get_fixture(s, state.range(0));
+		auto g = graph(f.edges.begin(), f.edges.end());
+		for (auto const& node : f.nodes) {
+			g.insert_node(node);
+		}
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(g == f.g);
+		}
+		finish(state, state.range(0));
+	}
+
+	// The same graph with its nodes interned in reverse order, so every edge is compared by value.
+	auto bm_equal_other_ids(benchmark::State& state, shape s) -> void {
+		auto const& f = get_fixture(s, state.range(0));
+		auto g = graph{};
+		for (auto node = f.nodes.rbegin(); node != f.nodes.rend(); ++node) {
+			g.insert_node(*node);
+		}
+		g.insert_edges(f.edges.begin(), f.edges.end());
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(g == f.g);
+		}
+		finish(state, state.range(0));
+	}
+
+	auto bm_equal_one_edge_less(benchmark::State& state, shape s) -> void {
+		auto const& f = get_fixture(s, state.range(0));
+		auto g = f.g;
+		g.erase_edge(g.begin());
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(g == f.g);
+		}
+		finish(state, state.range(0));
+	}
+
+	// As many nodes and edges, one weight changed: the fingerprints tell them apart.
+	auto bm_equal_other_weight(benchmark::State& state, shape s) -> void {
+		auto const& f = get_fixture(s, state.range(0));
+		auto g = f.g;
+		auto const [from, to, weight] = *std::prev(g.end());
+		g.erase_edge(std::prev(g.end()));
+		g.insert_edge(from, to, weight + 1);
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(g == f.g);
+		}
+		finish(state, state.range(0));
+	}
+
+	// std::hash returns the fingerprint the modifiers keep.
+	auto bm_fingerprint(benchmark::State& state, shape s) -> void {
+		auto const& f = get_fixture(s, state.range(0));
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(std::hash<graph>{}(f.g));
+		}
+		finish(state, state.range(0));
+	}
+
+	// Hashing a graph without the fingerprint: hashing what operator<< writes of it.
+	auto bm_hash_by_print(benchmark::State& state, shape s) -> void {
+		auto const& f = get_fixture(s, state.range(0));
+		for (auto _ : state) {
+			auto out = std::ostringstream{};
+			out << f.g;
+			benchmark::DoNotOptimize(std::hash<std::string>{}(out.str()));
+		}
+		finish(state, state.range(0));
+	}
+
+	// A copy is a snapshot, the graph copies its storage on the first write after one.
+	auto bm_copy_then_write(benchmark::State& state, shape s) -> void {
+		auto const& f = get_fixture(s, state.range(0));
+		auto g = f.g;
+		for (auto _ : state) {
+			auto const snapshot = g;
+			g.insert_node(-1);
+			g.erase_node(-1);
+			benchmark::DoNotOptimize(snapshot);
+		}
+		finish(state, state.range(0));
+	}
+
+	// The same with chunked_storage, where the writes copy the chunks they touch and not the graph.
+	auto bm_chunked_copy_then_write(benchmark::State& state, shape s) -> void {
+		auto const& f = get_fixture(s, state.range(0));
+		auto const edges = edges_for<chunked_graph>(f.edges);
+		auto g = chunked_graph(edges.begin(), edges.end());
+		for (auto const& node : f.nodes) {
+			g.insert_node(node);
+		}
+		for (auto _ : state) {
+			auto const snapshot = g;
+			g.insert_node(-1);
+			g.erase_node(-1);
+			benchmark::DoNotOptimize(snapshot);
+		}
+		finish(state, state.range(0));
+	}
+
+	auto bm_iteration(benchmark::State& state, shape s) -> void {
+		auto const& f = get_fixture(s, state.range(0));
+		for (auto _ : state) {
+			auto sum = 0L;
+			for (auto const& [from, to, weight] : f.g) {
+				sum += from + to + weight;
+			}
+			benchmark::DoNotOptimize(sum);
+		}
+		finish(state, state.range(0));
+	}
+
+	// Frozen snapshot, measured against the same probes as the graph benchmarks above
+
+	auto bm_csr_freeze(benchmark::State& state, shape s) -> void {
+		auto const& f = get_fixture(s, state.range(0));
+		for (auto _ : state) {
+			auto csr = csr_graph(f.g);
+			benchmark::DoNotOptimize(csr);
+		}
+		finish(state, state.range(0));
+	}
+
+	auto bm_csr_is_connected(benchmark::State& state, shape s) -> void {
+		auto const& f = get_fixture(s, state.range(0));
+		auto const srcs = sample(f.nodes, sample_size);
+		auto const dsts = sample(f.nodes, sample_size + 1);
+		auto i = std::size_t{0};
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(f.csr.is_connected(srcs[i], dsts[i]));
+			i = (i + 1) % sample_size;
+		}
+		finish(state, state.range(0));
+	}
+
+	auto bm_csr_weights(benchmark::State& state, shape s) -> void {
+		auto const& f = get_fixture(s, state.range(0));
+		auto const probes = sample(f.edges, sample_size);
+		auto i = std::size_t{0};
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(f.csr.weights(probes[i].from, probes[i].to));
+			i = (i + 1) % sample_size;
+		}
+		finish(state, state.range(0));
+	}
+
+	auto bm_csr_connections(benchmark::State& state, shape s) -> void {
+		auto const& f = get_fixture(s, state.range(0));
+		auto const probes = sample(f.edges, sample_size);
+		auto i = std::size_t{0};
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(f.csr.connections(probes[i].from));
+			i = (i + 1) % sample_size;
+		}
+		finish(state, state.range(0));
+	}
+
+	auto bm_csr_find(benchmark::State& state, shape s) -> void {
+		auto const& f = get_fixture(s, state.range(0));
+		auto const probes = sample(f.edges, sample_size);
+		auto i = std::size_t{0};
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(f.csr.find(probes[i].from, probes[i].to, probes[i].weight));
+			i = (i + 1) % sample_size;
+		}
+		finish(state, state.range(0));
+	}
+
+	auto bm_csr_iteration(benchmark::State& state, shape s) -> void {
+		auto const& f = get_fixture(s, state.range(0));
+		for (auto _ : state) {
+			auto sum = 0L;
+			for (auto const& [from, to, weight] : f.csr) {
+				sum += from + to + weight;
+			}
+			benchmark::DoNotOptimize(sum);
+		}
+		finish(state, state.range(0));
+	}
+
+	// Binary files, measured against bm_construct, which builds the same graph from its edges
+
+	// Writes the graph of every fixture to a file once, and removes the files at exit.
+	auto get_binary_file(shape s, std::int64_t edges) -> std::filesystem::path const& {
+		struct files {
+			std::map<std::pair<shape, std::int64_t>, std::filesystem::path> paths;
+			~files() {
+				for (auto const& [key, path] : paths) {
+					std::filesystem::remove(path);
+				}
+			}
+		};
+		static auto cache = files{};
+		auto const key = std::pair{s, edges};
+		if (auto const found = cache.paths.find(key); found != cache.paths.end()) {
+			return found->second;
+		}
+		auto const name = "gdwg_graph_benchmark_" + std::to_string(static_cast<int>(s)) + "_"
+		                  + std::to_string(edges) + ".bin";
+		auto path = std::filesystem::temp_directory_path() / name;
+		auto out = std::ofstream(path, std::ios::binary);
+		gdwg::write_binary(out, get_fixture(s, edges).g);
+		return cache.paths.emplace(key, std::move(path)).first->second;
+	}
+
+	auto bm_write_binary(benchmark::State& state, shape s) -> void {
+		auto const& f = get_fixture(s, state.range(0));
+		auto out = std::ofstream(get_binary_file(s, state.range(0)), std::ios::binary);
+		for (auto _ : state) {
+			out.seekp(0);
+			gdwg::write_binary(out, f.g);
+		}
+		finish(state, state.range(0));
+	}
+
+	auto bm_read_binary(benchmark::State& state, shape s) -> void {
+		auto in = std::ifstream(get_binary_file(s, state.range(0)), std::ios::binary);
+		for (auto _ : state) {
+			in.seekg(0);
+			auto g = gdwg::read_binary<int, int>(in);
+			benchmark::DoNotOptimize(g);
+		}
+		finish(state, state.range(0));
+	}
+
+	auto bm_map_binary(benchmark::State& state, shape s) -> void {
+		auto const& path = get_binary_file(s, state.range(0));
+		for (auto _ : state) {
+			auto g = mapped_graph(path);
+			benchmark::DoNotOptimize(g);
+		}
+		finish(state, state.range(0));
+	}
+
+	auto bm_map_binary_header_only(benchmark::State& state, shape s) -> void {
+		auto const& path = get_binary_file(s, state.range(0));
+		for (auto _ : state) {
+			auto g = mapped_graph(path, gdwg::file_check::header_only);
+			benchmark::DoNotOptimize(g);
+		}
+		finish(state, state.range(0));
+	}
+
+	auto bm_mapped_is_connected(benchmark::State& state, shape s) -> void {
+		auto const& f = get_fixture(s, state.range(0));
+		auto const mapped = mapped_graph(get_binary_file(s, state.range(0)));
+		auto const srcs = sample(f.nodes, sample_size);
+		auto const dsts = sample(f.nodes, sample_size + 1);
+		auto i = std::size_t{0};
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(mapped.is_connected(srcs[i], dsts[i]));
+			i = (i + 1) % sample_size;
+		}
+		finish(state, state.range(0));
+	}
+
+	// Text, as operator<< writes it, read back by parse_graph and by a loader built on operator>>
+
+	auto get_text(shape s, std::int64_t edges) -> std::string const& {
+		static auto cache = std::map<std::pair<shape, std::int64_t>, std::string>{};
+		auto const key = std::pair{s, edges};
+		if (auto const found = cache.find(key); found != cache.end()) {
+			return found->second;
+		}
+		auto out = std::ostringstream{};
+		out << get_fixture(s, edges).g;
+		return cache.emplace(key, std::move(out).str()).first->second;
+	}
+
+	auto bm_parse_graph(benchmark::State& state, shape s) -> void {
+		auto const& text = get_text(s, state.range(0));
+		for (auto _ : state) {
+			auto g = gdwg::parse_graph<int, int>(text);
+			benchmark::DoNotOptimize(g);
+		}
+		state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(text.size()));
+		finish(state, state.range(0));
+	}
+
+	auto bm_parse_graph_stream(benchmark::State& state, shape s) -> void {
+		auto const& text = get_text(s, state.range(0));
+		for (auto _ : state) {
+			auto in = std::istringstream(text);
+			auto g = gdwg::parse_graph<int, int>(in);
+			benchmark::DoNotOptimize(g);
+		}
+		state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(text.size()));
+		finish(state, state.range(0));
+	}
+
+	auto bm_parse_graph_flat(benchmark::State& state, shape s) -> void {
+		auto const& text = get_text(s, state.range(0));
+		for (auto _ : state) {
+			auto g = gdwg::parse_graph<int, int, gdwg::flat_storage>(text);
+			benchmark::DoNotOptimize(g);
+		}
+		state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(text.size()));
+		finish(state, state.range(0));
+	}
+
+	auto bm_print(benchmark::State& state, shape s) -> void {
+		auto const& f = get_fixture(s, state.range(0));
+		auto out = std::ofstream("/dev/null");
+		for (auto _ : state) {
+			out << f.g;
+			out.flush();
+		}
+		state.SetBytesProcessed(state.iterations()
+		                        * static_cast<std::int64_t>(get_text(s, state.range(0)).size()));
+		finish(state, state.range(0));
+	}
+
+	auto bm_write_graph(benchmark::State& state, shape s) -> void {
+		auto const& f = get_fixture(s, state.range(0));
+		auto const fd = ::open("/dev/null", O_WRONLY);
+		for (auto _ : state) {
+			gdwg::write_graph(f.g, fd);
+		}
+		::close(fd);
+		state.SetBytesProcessed(state.iterations()
+		                        * static_cast<std::int64_t>(get_text(s, state.range(0)).size()));
+		finish(state, state.range(0));
+	}
+
+	// The loader every consumer wrote before parse_graph: a token at a time through operator>>,
+	// inserting as it goes.
+	auto bm_parse_by_stream(benchmark::State& state, shape s) -> void {
+		auto const& text = get_text(s, state.range(0));
+		for (auto _ : state) {
+			auto in = std::istringstream(text);
+			auto g = graph{};
+			auto src = 0;
+			auto token = std::string{};
+			while (in >> src >> token) { // token is "("
+				g.insert_node(src);
+				auto dst = 0;
+				auto weight = 0;
+				while (in >> token and token != ")") {
+					dst = std::stoi(token);
+					in >> token >> weight; // token is "|"
+					g.insert_node(dst);
+					g.insert_edge(src, dst, weight);
+				}
+			}
+			benchmark::DoNotOptimize(g);
+		}
+		state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(text.size()));
+		finish(state, state.range(0));
+	}
+
+	// Flat storage, measured against the same probes as the graph benchmarks above
+
+	auto bm_flat_insert_edges(benchmark::State& state, shape s) -> void {
+		auto const& f = get_fixture(s, state.range(0));
+		auto g = f.flat;
+		auto batch = edges_for<flat_graph>(sample(f.edges, sample_size));
+		for (auto& i : batch) {
+			i.weight = 1000; // out of the range used by make_edges, so every insertion is new
+		}
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(g.insert_edges(batch.begin(), batch.end()));
+			for (auto& i : batch) {
+				++i.weight;
+			}
+		}
+		state.SetComplexityN(state.range(0));
+		state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations())
+		                        * static_cast<std::int64_t>(sample_size));
+	}
+
+	auto bm_flat_is_connected(benchmark::State& state, shape s) -> void {
+		auto const& f = get_fixture(s, state.range(0));
+		auto const srcs = sample(f.nodes, sample_size);
+		auto const dsts = sample(f.nodes, sample_size + 1);
+		auto i = std::size_t{0};
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(f.flat.is_connected(srcs[i], dsts[i]));
+			i = (i + 1) % sample_size;
+		}
+		finish(state, state.range(0));
+	}
+
+	auto bm_flat_find(benchmark::State& state, shape s) -> void {
+		auto const& f = get_fixture(s, state.range(0));
+		auto const probes = sample(f.edges, sample_size);
+		auto i = std::size_t{0};
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(f.flat.find(probes[i].from, probes[i].to, probes[i].weight));
+			i = (i + 1) % sample_size;
+		}
+		finish(state, state.range(0));
+	}
+
+	auto bm_flat_copy(benchmark::State& state, shape s) -> void {
+		auto const& f = get_fixture(s, state.range(0));
+		for (auto _ : state) {
+			auto copy = f.flat;
+			benchmark::DoNotOptimize(copy);
+		}
+		finish(state, state.range(0));
+	}
+
+	auto bm_flat_iteration(benchmark::State& state, shape s) -> void {
+		auto const& f = get_fixture(s, state.range(0));
+		for (auto _ : state) {
+			auto sum = 0L;
+			for (auto const& [from, to, weight] : f.flat) {
+				sum += from + to + weight;
+			}
+			benchmark::DoNotOptimize(sum);
+		}
+		finish(state, state.range(0));
+	}
+
+	// Single source shortest paths, from a different source in every iteration
+	auto bm_dijkstra(benchmark::State& state, shape s) -> void {
+		auto const& f = get_fixture(s, state.range(0));
+		auto const sources = sample(f.edges, sample_size);
+		auto i = std::size_t{0};
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(gdwg::dijkstra(f.positive, sources[i].from));
+			i = (i + 1) % sample_size;
+		}
+		finish(state, state.range(0));
+	}
+
+	// What dijkstra replaces: a search through connections and weights, which allocate two
+	// vectors for every node it visits.
+	auto bm_dijkstra_by_connections(benchmark::State& state, shape s) -> void {
+		auto const& f = get_fixture(s, state.range(0));
+		auto const sources = sample(f.edges, sample_size);
+		auto i = std::size_t{0};
+		for (auto _ : state) {
+			auto dist = std::map<int, int>{{sources[i].from, 0}};
+			auto queue = std::priority_queue<std::pair<int, int>,
+			                                 std::vector<std::pair<int, int>>,
+			                                 std::greater<>>{};
+			queue.emplace(0, sources[i].from);
+			while (!queue.empty()) {
+				auto const [d, u] = queue.top();
+				queue.pop();
+				if (d != dist[u]) {
+					continue; // an outdated entry
+				}
+				for (auto const v : f.positive.connections(u)) {
+					auto const length = d + f.positive.weights(u, v).front();
+					if (auto const [iter, inserted] = dist.emplace(v, length);
+					    inserted or length < iter->second) {
+						iter->second = length;
+						queue.emplace(length, v);
+					}
+				}
+			}
+			benchmark::DoNotOptimize(dist);
+			i = (i + 1) % sample_size;
+		}
+		finish(state, state.range(0));
+	}
+
+	auto bm_bellman_ford(benchmark::State& state, shape s) -> void {
+		auto const& f = get_fixture(s, state.range(0));
+		auto const sources = sample(f.edges, sample_size);
+		auto i = std::size_t{0};
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(gdwg::bellman_ford(f.positive, sources[i].from));
+			i = (i + 1) % sample_size;
+		}
+		finish(state, state.range(0));
+	}
+
+	// Everything a node leads to, from a different source in every iteration
+	auto bm_reachable(benchmark::State& state, shape s) -> void {
+		auto const& f = get_fixture(s, state.range(0));
+		auto const sources = sample(f.edges, sample_size);
+		auto t = gdwg::traversal(f.g);
+		auto i = std::size_t{0};
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(t.reachable_from(sources[i].from));
+			i = (i + 1) % sample_size;
+		}
+		finish(state, state.range(0));
+	}
+
+	// What traversal replaces: a search through connections, which allocates a vector for every
+	// node it visits.
+	auto bm_reachable_by_connections(benchmark::State& state, shape s) -> void {
+		auto const& f = get_fixture(s, state.range(0));
+		auto const sources = sample(f.edges, sample_size);
+		auto i = std::size_t{0};
+		for (auto _ : state) {
+			auto seen = std::set<int>{sources[i].from};
+			auto stack = std::vector<int>{sources[i].from};
+			while (!stack.empty()) {
+				auto const u = stack.back();
+				stack.pop_back();
+				for (auto const v : f.g.connections(u)) {
+					if (seen.insert(v).second) {
+						stack.push_back(v);
+					}
+				}
+			}
+			benchmark::DoNotOptimize(seen);
+			i = (i + 1) % sample_size;
+		}
+		finish(state, state.range(0));
+	}
+
+	auto bm_reachable_parallel(benchmark::State& state, shape s) -> void {
+		auto const& f = get_fixture(s, state.range(0));
+		auto const sources = sample(f.edges, sample_size);
+		auto t = gdwg::traversal(f.g);
+		auto i = std::size_t{0};
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(gdwg::reachable_from(std::execution::par, t, sources[i].from));
+			i = (i + 1) % sample_size;
+		}
+		finish(state, state.range(0));
+	}
+
+	// Whether an edge's dst is within three hops of the src of another edge.
+	auto bm_reachable_within(benchmark::State& state, shape s) -> void {
+		auto const& f = get_fixture(s, state.range(0));
+		auto const probes = sample(f.edges, sample_size);
+		auto t = gdwg::traversal(f.g);
+		auto i = std::size_t{0};
+		for (auto _ : state) {
+			auto const dst = probes[(i + 1) % sample_size].to;
+			benchmark::DoNotOptimize(t.reachable(probes[i].from, dst, 3));
+			i = (i + 1) % sample_size;
+		}
+		finish(state, state.range(0));
+	}
+
+	// The parallel search on a million sparse edges, run on state.range(0) threads at most.
+	auto bm_reachable_threads(benchmark::State& state) -> void {
+		auto const& f = get_fixture(shape::sparse, max_edges);
+		auto const sources = sample(f.edges, sample_size);
+		auto const threads = static_cast<std::size_t>(state.range(0));
+		auto const limit =
+		   tbb::global_control(tbb::global_control::max_allowed_parallelism, threads);
+		auto t = gdwg::traversal(f.g);
+		auto i = std::size_t{0};
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(gdwg::reachable_from(std::execution::par, t, sources[i].from));
+			i = (i + 1) % sample_size;
+		}
+		state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()));
+	}
+
+	// Threads, reading one sparse graph of 1e5 edges through each kind of lock
+
+	struct shared_fixture {
+		std::vector<graph::value_type> edges = make_edges(shape::sparse, 100'000);
+		graph g = graph(edges.begin(), edges.end());
+		std::vector<int> nodes = g.nodes();
+		std::vector<chunked_graph::value_type> chunked_edges = edges_for<chunked_graph>(edges);
+		concurrent_graph concurrent = concurrent_graph(chunked_edges.begin(), chunked_edges.end());
+		std::mutex mutex;
+		std::shared_mutex shared_mutex;
+	};
+
+	// Built once, by whichever thread of a benchmark gets here first.
+	auto get_shared_fixture() -> shared_fixture& {
+		static auto f = shared_fixture{};
+		return f;
+	}
+
+	template<typename F>
+	auto run_reads(benchmark::State& state, F is_connected) -> void {
+		auto const& f = get_shared_fixture();
+		auto const seed = sample_size + static_cast<std::size_t>(state.thread_index());
+		auto const srcs = sample(f.nodes, seed);
+		auto const dsts = sample(f.nodes, seed + 1);
+		auto i = std::size_t{0};
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(is_connected(srcs[i], dsts[i]));
+			i = (i + 1) % sample_size;
+		}
+		state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()));
+	}
+
+	// What concurrent_graph replaces: one mutex around the graph.
+	auto bm_mutex_reads(benchmark::State& state) -> void {
+		auto& f = get_shared_fixture();
+		run_reads(state, [&f](int src, int dst) {
+			auto const lock = std::scoped_lock(f.mutex);
+			return f.g.is_connected(src, dst);
+		});
+	}
+
+	auto bm_shared_mutex_reads(benchmark::State& state) -> void {
+		auto& f = get_shared_fixture();
+		run_reads(state, [&f](int src, int dst) {
+			auto const lock = std::shared_lock(f.shared_mutex);
+			return f.g.is_connected(src, dst);
+		});
+	}
+
+	auto bm_concurrent_reads(benchmark::State& state) -> void {
+		auto& f = get_shared_fixture();
+		run_reads(state, [&f](int src, int dst) { return f.concurrent.is_connected(src, dst); });
+	}
+
+	// One operation in a hundred is a write.
+	auto bm_concurrent_mixed(benchmark::State& state) -> void {
+		auto& f = get_shared_fixture();
+		auto const weight = 1000 + state.thread_index(); // each thread writes edges of its own
+		auto count = 0;
+		run_reads(state, [&f, &count, weight](int src, int dst) {
+			if (++count % 100 != 0) {
+				return f.concurrent.is_connected(src, dst);
+			}
+			return count % 200 == 0 ? f.concurrent.erase_edge(src, src, weight)
+			                        : f.concurrent.insert_edge(src, src, weight);
+		});
+	}
+} // namespace
+
+auto operator new(std::size_t size) -> void* {
+	allocations.fetch_add(1, std::memory_order_relaxed);
+	if (auto* const p = std::malloc(size == 0 ? 1 : size)) {
+		return p;
+	}
+	throw std::bad_alloc{};
+}
+
+auto operator delete(void* p) noexcept -> void {
+	std::free(p);
+}
+
+auto operator delete(void* p, std::size_t) noexcept -> void {
+	std::free(p);
+}
+
+// std::pmr::new_delete_resource() allocates through the aligned forms
+auto operator new(std::size_t size, std::align_val_t alignment) -> void* {
+	allocations.fetch_add(1, std::memory_order_relaxed);
+	auto const align = static_cast<std::size_t>(alignment);
+	auto const rounded = (size + align - 1) / align * align; // aligned_alloc wants a multiple
+	if (auto* const p = std::aligned_alloc(align, rounded == 0 ? align : rounded)) {
+		return p;
+	}
+	throw std::bad_alloc{};
+}
+
+auto operator delete(void* p, std::align_val_t) noexcept -> void {
+	std::free(p);
+}
+
+auto operator delete(void* p, std::size_t, std::align_val_t) noexcept -> void {
+	std::free(p);
+}
+
+#define GRAPH_BENCHMARK(func)                                                                      \
+	BENCHMARK_CAPTURE(func, sparse, shape::sparse)                                                  \
+	   ->RangeMultiplier(10)                                                                        \
+	   ->Range(min_edges, max_edges)                                                                \
+	   ->Complexity();                                                                              \
+	BENCHMARK_CAPTURE(func, dense, shape::dense)                                                    \
+	   ->RangeMultiplier(10)                                                                        \
+	   ->Range(min_edges, max_edges)                                                                \
+	   ->Complexity();                                                                              \
+	BENCHMARK_CAPTURE(func, power_law, shape::power_law)                                            \
+	   ->RangeMultiplier(10)                                                                        \
+	   ->Range(min_edges, max_edges)                                                                \
+	   ->Complexity()
+
+GRAPH_BENCHMARK(bm_insert_node);
+GRAPH_BENCHMARK(bm_insert_edge);
+GRAPH_BENCHMARK(bm_erase_node);
+GRAPH_BENCHMARK(bm_erase_edge);
+GRAPH_BENCHMARK(bm_replace_node);
+GRAPH_BENCHMARK(bm_merge_replace_node);
+GRAPH_BENCHMARK(bm_insert_edges);
+GRAPH_BENCHMARK(bm_erase_nodes);
+GRAPH_BENCHMARK(bm_is_connected);
+GRAPH_BENCHMARK(bm_weights);
+GRAPH_BENCHMARK(bm_connections);
+GRAPH_BENCHMARK(bm_connections_view);
+GRAPH_BENCHMARK(bm_nodes);
+GRAPH_BENCHMARK(bm_nodes_view);
+GRAPH_BENCHMARK(bm_weights_view);
+GRAPH_BENCHMARK(bm_out_edges);
+GRAPH_BENCHMARK(bm_predecessors);
+GRAPH_BENCHMARK(bm_predecessors_by_scan);
+GRAPH_BENCHMARK(bm_in_degree);
+GRAPH_BENCHMARK(bm_in_degree_by_walk);
+GRAPH_BENCHMARK(bm_out_degree);
+GRAPH_BENCHMARK(bm_edge_count);
+GRAPH_BENCHMARK(bm_edge_count_by_walk);
+GRAPH_BENCHMARK(bm_find);
+GRAPH_BENCHMARK(bm_construct);
+GRAPH_BENCHMARK(bm_construct_parallel);
+GRAPH_BENCHMARK(bm_scratch_heap);
+GRAPH_BENCHMARK(bm_scratch_arena);
+GRAPH_BENCHMARK(bm_copy);
+GRAPH_BENCHMARK(bm_copy_then_write);
+GRAPH_BENCHMARK(bm_chunked_copy_then_write);
+GRAPH_BENCHMARK(bm_equal);
+GRAPH_BENCHMARK(bm_equal_other_ids);
+GRAPH_BENCHMARK(bm_equal_one_edge_less);
+GRAPH_BENCHMARK(bm_equal_other_weight);
+GRAPH_BENCHMARK(bm_fingerprint);
+GRAPH_BENCHMARK(bm_hash_by_print);
+GRAPH_BENCHMARK(bm_iteration);
+GRAPH_BENCHMARK(bm_csr_freeze);
+GRAPH_BENCHMARK(bm_csr_is_connected);
+GRAPH_BENCHMARK(bm_csr_weights);
+GRAPH_BENCHMARK(bm_csr_connections);
+GRAPH_BENCHMARK(bm_csr_find);
+GRAPH_BENCHMARK(bm_csr_iteration);
+GRAPH_BENCHMARK(bm_write_binary);
+GRAPH_BENCHMARK(bm_read_binary);
+GRAPH_BENCHMARK(bm_map_binary);
+GRAPH_BENCHMARK(bm_map_binary_header_only);
+GRAPH_BENCHMARK(bm_mapped_is_connected);
+GRAPH_BENCHMARK(bm_parse_graph);
+GRAPH_BENCHMARK(bm_parse_graph_stream);
+GRAPH_BENCHMARK(bm_parse_graph_flat);
+GRAPH_BENCHMARK(bm_parse_by_stream);
+GRAPH_BENCHMARK(bm_print);
+GRAPH_BENCHMARK(bm_write_graph);
+GRAPH_BENCHMARK(bm_flat_insert_edges);
+GRAPH_BENCHMARK(bm_flat_is_connected);
+GRAPH_BENCHMARK(bm_flat_find);
+GRAPH_BENCHMARK(bm_flat_copy);
+GRAPH_BENCHMARK(bm_flat_iteration);
+GRAPH_BENCHMARK(bm_dijkstra);
+GRAPH_BENCHMARK(bm_dijkstra_by_connections);
+GRAPH_BENCHMARK(bm_bellman_ford);
+GRAPH_BENCHMARK(bm_reachable);
+GRAPH_BENCHMARK(bm_reachable_by_connections);
+GRAPH_BENCHMARK(bm_reachable_parallel);
+GRAPH_BENCHMARK(bm_reachable_within);
+BENCHMARK(bm_mutex_reads)->ThreadRange(1, 32)->UseRealTime();
+BENCHMARK(bm_shared_mutex_reads)->ThreadRange(1, 32)->UseRealTime();
+BENCHMARK(bm_concurrent_reads)->ThreadRange(1, 32)->UseRealTime();
+BENCHMARK(bm_concurrent_mixed)->ThreadRange(1, 32)->UseRealTime();
+BENCHMARK(bm_construct_threads)->RangeMultiplier(2)->Range(1, 32)->UseRealTime();
+BENCHMARK(bm_reachable_threads)->RangeMultiplier(2)->Range(1, 32)->UseRealTime();
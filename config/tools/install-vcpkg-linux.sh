@@ -16,5 +16,6 @@ cp ../config/cmake/triplets/* triplets/community/.
 ./vcpkg install --clean-after-build fmt:x64-linux-libcxx
 ./vcpkg install --clean-after-build gsl-lite:x64-linux-libcxx
 ./vcpkg install --clean-after-build range-v3:x64-linux-libcxx
+./vcpkg install --clean-after-build tbb:x64-linux-libcxx
 cd ..
 sed -i 's#/import/kamen/1/cs6771#${workspaceFolder}#' .vscode/cmake-kits.json
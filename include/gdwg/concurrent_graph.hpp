@@ -0,0 +1,214 @@
+#ifndef GDWG_CONCURRENT_GRAPH_HPP
+#define GDWG_CONCURRENT_GRAPH_HPP
+
+#include <array>
+#include <atomic>
+#include <concepts>
+#include <concepts/concepts.hpp>
+#include <cstddef>
+#include <initializer_list>
+#include <memory_resource>
+#include <optional>
+#include <ostream>
+#include <shared_mutex>
+#include <utility>
+#include <vector>
+
+#include "gdwg/graph.hpp"
+
+namespace gdwg {
+	// A graph that any number of threads can use at the same time. Readers run in parallel with
+	// each other and writers run alone, like with one std::shared_mutex, except that the lock is
+	// split into stripes on their own cache lines: a reader only locks the stripe of its thread, so
+	// readers on different cores never write to the same memory, and a writer locks every stripe.
+	// Writes cost a little more than with one mutex, reads scale with the number of cores.
+	// Nothing here returns an iterator, which would outlive the lock. A snapshot is a plain graph
+	// that shares the nodes and edges as they were, and can be walked for as long as needed. With
+	// chunked_storage, the default, the first write after a snapshot copies only the chunks it
+	// touches; with the other policies it copies the whole graph.
+	template<concepts::regular N, concepts::regular E, typename Storage = chunked_storage>
+	requires concepts::totally_ordered<N>and concepts::totally_ordered<E> class concurrent_graph {
+	public:
+		using graph_type = graph<N, E, Storage>;
+		using value_type = typename graph_type::value_type;
+
+		// Constructors
+		concurrent_graph() = default;
+		explicit concurrent_graph(std::pmr::memory_resource* resource)
+		: graph_{resource} {}
+		concurrent_graph(std::initializer_list<N> il,
+		                 std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+		: graph_(il, resource) {}
+		template<typename I, typename S>
+		requires std::constructible_from<graph_type, I, S, std::pmr::memory_resource*>
+		concurrent_graph(I first,
+		                 S last,
+		                 std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+		: graph_(std::move(first), std::move(last), resource) {}
+		explicit concurrent_graph(graph_type g) noexcept
+		: graph_{std::move(g)} {}
+		// The stripes cannot move, and copying the graph is what snapshot is for.
+		concurrent_graph(concurrent_graph const&) = delete;
+		auto operator=(concurrent_graph const&) -> concurrent_graph& = delete;
+		~concurrent_graph() = default;
+
+		// Modifiers
+		auto insert_node(N const& value) -> bool {
+			return write([&](graph_type& g) { return g.insert_node(value); });
+		}
+		auto insert_edge(N const& src, N const& dst, E const& weight) -> bool {
+			return write([&](graph_type& g) { return g.insert_edge(src, dst, weight); });
+		}
+		auto replace_node(N const& old_data, N const& new_data) -> bool {
+			return write([&](graph_type& g) { return g.replace_node(old_data, new_data); });
+		}
+		auto merge_replace_node(N const& old_data, N const& new_data) -> void {
+			write([&](graph_type& g) { g.merge_replace_node(old_data, new_data); });
+		}
+		auto erase_node(N const& value) -> bool {
+			return write([&](graph_type& g) { return g.erase_node(value); });
+		}
+		auto erase_edge(N const& src, N const& dst, E const& weight) -> bool {
+			return write([&](graph_type& g) { return g.erase_edge(src, dst, weight); });
+		}
+		// A batch is applied under a single lock, so readers see all of it or none of it.
+		template<typename I, typename S>
+		auto insert_edges(I first, S last) -> std::size_t {
+			return write([&](graph_type& g) {
+				return g.insert_edges(std::move(first), std::move(last));
+			});
+		}
+		template<typename I, typename S>
+		auto erase_edges(I first, S last) -> std::size_t {
+			return write([&](graph_type& g) {
+				return g.erase_edges(std::move(first), std::move(last));
+			});
+		}
+		template<typename I, typename S>
+		auto erase_nodes(I first, S last) -> std::size_t {
+			return write([&](graph_type& g) {
+				return g.erase_nodes(std::move(first), std::move(last));
+			});
+		}
+		auto clear() -> void {
+			write([](graph_type& g) { g.clear(); });
+		}
+		// Applies f to the graph while no other thread uses it, for changes made of several calls.
+		template<typename F>
+		auto update(F f) -> decltype(f(std::declval<graph_type&>())) {
+			return write(f);
+		}
+
+		// Accessors
+		[[nodiscard]] auto is_node(N const& value) const -> bool {
+			return read([&](graph_type const& g) { return g.is_node(value); });
+		}
+		[[nodiscard]] auto empty() const -> bool {
+			return read([](graph_type const& g) { return g.empty(); });
+		}
+		[[nodiscard]] auto node_count() const -> std::size_t {
+			return read([](graph_type const& g) { return g.node_count(); });
+		}
+		[[nodiscard]] auto edge_count() const -> std::size_t {
+			return read([](graph_type const& g) { return g.edge_count(); });
+		}
+		[[nodiscard]] auto fingerprint() const -> std::size_t
+		   requires detail::hashable<N> and detail::hashable<E> {
+			return read([](graph_type const& g) { return g.fingerprint(); });
+		}
+		[[nodiscard]] auto is_connected(N const& src, N const& dst) const -> bool {
+			return read([&](graph_type const& g) { return g.is_connected(src, dst); });
+		}
+		[[nodiscard]] auto nodes() const -> std::vector<N> {
+			return read([](graph_type const& g) { return g.nodes(); });
+		}
+		[[nodiscard]] auto weights(N const& src, N const& dst) const -> std::vector<E> {
+			return read([&](graph_type const& g) { return g.weights(src, dst); });
+		}
+		// Returns the edge if it is in the graph.
+		[[nodiscard]] auto find(N const& src, N const& dst, E const& weight) const
+		   -> std::optional<value_type> {
+			return read([&](graph_type const& g) -> std::optional<value_type> {
+				if (g.find(src, dst, weight) == g.end()) {
+					return std::nullopt;
+				}
+				return value_type{src, dst, weight};
+			});
+		}
+		[[nodiscard]] auto connections(N const& src) const -> std::vector<N> {
+			return read([&](graph_type const& g) { return g.connections(src); });
+		}
+		[[nodiscard]] auto predecessors(N const& dst) const -> std::vector<N> {
+			return read([&](graph_type const& g) { return g.predecessors(dst); });
+		}
+		[[nodiscard]] auto out_degree(N const& src) const -> std::size_t {
+			return read([&](graph_type const& g) { return g.out_degree(src); });
+		}
+		[[nodiscard]] auto in_degree(N const& dst) const -> std::size_t {
+			return read([&](graph_type const& g) { return g.in_degree(dst); });
+		}
+		[[nodiscard]] auto in_edges(N const& dst) const -> std::vector<value_type> {
+			return read([&](graph_type const& g) { return g.in_edges(dst); });
+		}
+		// Returns the graph as it is now, in the same memory resource. Later writes don't change it.
+		[[nodiscard]] auto snapshot() const -> graph_type {
+			return read([](graph_type const& g) { return graph_type(g, g.resource()); });
+		} // O(1), then O((n + e) / chunk size) and the chunks written to for the next write
+
+		// Comparisons
+		[[nodiscard]] auto operator==(concurrent_graph const& other) const -> bool {
+			return snapshot() == other.snapshot(); // never holds both locks at once
+		}
+
+		// Extractor
+		friend auto operator<<(std::ostream& os, concurrent_graph const& g) -> std::ostream& {
+			return os << g.snapshot();
+		}
+
+	private:
+		// Enough for the cores of a large machine; more stripes only make writers slower.
+		static constexpr auto stripe_count = std::size_t{32};
+		// The usual size of a cache line. std::hardware_destructive_interference_size would do,
+		// but its value may differ between the translation units of one program.
+		static constexpr auto cache_line = std::size_t{64};
+		struct alignas(cache_line) stripe {
+			std::shared_mutex mutex;
+		};
+
+		mutable std::array<stripe, stripe_count> stripes_{};
+		graph_type graph_;
+
+		// Threads are given stripes in turn and keep theirs, so up to stripe_count threads never
+		// share one. Hashing thread ids would not do: they are often aligned addresses.
+		inline static auto next_stripe = std::atomic<std::size_t>{0};
+		[[nodiscard]] static auto own_stripe() noexcept -> std::size_t {
+			thread_local auto const index =
+			   next_stripe.fetch_add(1, std::memory_order_relaxed) % stripe_count;
+			return index;
+		}
+		template<typename F>
+		auto read(F f) const -> decltype(f(std::declval<graph_type const&>())) {
+			auto const lock = std::shared_lock(stripes_[own_stripe()].mutex);
+			return f(graph_);
+		}
+		// Writers lock the stripes in order, so two writers never wait for each other in a cycle.
+		template<typename F>
+		auto write(F f) -> decltype(f(std::declval<graph_type&>())) {
+			struct unlock_all {
+				std::array<stripe, stripe_count>& stripes;
+				std::size_t locked = 0;
+				~unlock_all() {
+					while (locked > 0) {
+						stripes[--locked].mutex.unlock();
+					}
+				}
+			} guard{stripes_};
+			for (; guard.locked < stripe_count; ++guard.locked) {
+				stripes_[guard.locked].mutex.lock();
+			}
+			return f(graph_);
+		}
+	};
+} // namespace gdwg
+
+#endif // GDWG_CONCURRENT_GRAPH_HPP
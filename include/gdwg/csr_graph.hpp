@@ -0,0 +1,190 @@
+#ifndef GDWG_CSR_GRAPH_HPP
+#define GDWG_CSR_GRAPH_HPP
+
+#include <algorithm>
+#include <concepts/concepts.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <range/v3/utility/common_tuple.hpp>
+#include <stdexcept>
+#include <vector>
+
+#include "gdwg/graph.hpp"
+
+namespace gdwg {
+	// A frozen copy of a graph, laid out in compressed sparse row form: the outgoing edges of
+	// nodes_[i] are the positions [offsets_[i], offsets_[i + 1]) of dsts_ and weights_, where dsts_
+	// holds the positions of the destination nodes in nodes_. Everything is sorted exactly like the
+	// edges of a graph, so queries are binary searches over contiguous arrays.
+	// A csr_graph is never modified after construction, every member is const, and any number of
+	// threads can read one at the same time without locking.
+	template<concepts::regular N, concepts::regular E>
+	requires concepts::totally_ordered<N>and concepts::totally_ordered<E> class csr_graph {
+	public:
+		class iterator {
+		public:
+			using value_type = ranges::common_tuple<N, N, E>;
+			using difference_type = std::ptrdiff_t;
+			using iterator_category = std::bidirectional_iterator_tag;
+			iterator() = default;
+
+			explicit iterator(csr_graph const* g, std::size_t src, std::size_t edge) noexcept
+			: g_{g}
+			, src_{src}
+			, edge_{edge} {}
+			auto operator*() const noexcept -> ranges::common_tuple<N const, N const, E const> {
+				return ranges::common_tuple<N, N, E>(g_->nodes_[src_],
+				                                     g_->nodes_[g_->dsts_[edge_]],
+				                                     g_->weights_[edge_]);
+			}
+			auto operator++() noexcept -> iterator& {
+				++edge_;
+				// skip the nodes whose edges all come before edge_, the ones without edges too
+				while (src_ < g_->nodes_.size() and g_->offsets_[src_ + 1] <= edge_) {
+					++src_;
+				}
+				return *this;
+			}
+			auto operator++(int) noexcept -> iterator {
+				auto temp = *this;
+				++*this;
+				return temp;
+			}
+			auto operator--() noexcept -> iterator& {
+				--edge_;
+				while (g_->offsets_[src_] > edge_) {
+					--src_;
+				}
+				return *this;
+			}
+			auto operator--(int) noexcept -> iterator {
+				auto temp = *this;
+				--*this;
+				return temp;
+			}
+			auto operator==(iterator const& other) const noexcept -> bool {
+				return edge_ == other.edge_;
+			}
+
+		private:
+			csr_graph const* g_ = nullptr;
+			std::size_t src_ = 0;
+			std::size_t edge_ = 0;
+		};
+
+		// Constructors
+		csr_graph() = default;
+		template<typename Storage>
+		explicit csr_graph(graph<N, E, Storage> const& g)
+		: nodes_{g.nodes()} {
+			offsets_.reserve(nodes_.size() + 1); // offsets_ already holds the start of nodes_[0]
+			auto src = std::size_t{0};
+			for (auto const& [from, to, weight] : g) { // in (src, dst, weight) order
+				while (nodes_[src] < from) {
+					offsets_.push_back(dsts_.size()); // where the edges of the next node start
+					++src;
+				}
+				dsts_.push_back(static_cast<std::uint32_t>(position(to)));
+				weights_.push_back(weight);
+			}
+			while (offsets_.size() <= nodes_.size()) {
+				offsets_.push_back(dsts_.size());
+			}
+		} // O(n + e log(n))
+
+		// Accessors
+		[[nodiscard]] auto is_node(N const& value) const noexcept -> bool {
+			return position(value) != nodes_.size();
+		} // O(log(n))
+		[[nodiscard]] auto empty() const noexcept -> bool {
+			return nodes_.empty();
+		}
+		[[nodiscard]] auto is_connected(N const& src, N const& dst) const -> bool {
+			auto const s = position(src);
+			auto const d = position(dst);
+			if (s == nodes_.size() or d == nodes_.size()) {
+				throw std::runtime_error("Cannot call gdwg::csr_graph<N, E>::is_connected if src or "
+				                         "dst node don't exist in the graph");
+			}
+			return std::binary_search(dsts_begin(s), dsts_end(s), d);
+		} // O(log(n) + log(d)), d is the out-degree of src
+		[[nodiscard]] auto nodes() const -> std::vector<N> {
+			return nodes_;
+		} // O(n)
+		[[nodiscard]] auto weights(N const& src, N const& dst) const -> std::vector<E> {
+			auto const s = position(src);
+			auto const d = position(dst);
+			if (s == nodes_.size() or d == nodes_.size()) {
+				throw std::runtime_error("Cannot call gdwg::csr_graph<N, E>::weights if src or dst "
+				                         "node don't exist in the graph");
+			}
+			auto const [first, last] = std::equal_range(dsts_begin(s), dsts_end(s), d);
+			return std::vector<E>(weights_.begin() + (first - dsts_.begin()),
+			                      weights_.begin() + (last - dsts_.begin()));
+		} // O(log(n) + log(d) + k), k is the number of edges from src to dst
+		[[nodiscard]] auto find(N const& src, N const& dst, E const& weight) const -> iterator {
+			auto const s = position(src);
+			auto const d = position(dst);
+			if (s == nodes_.size() or d == nodes_.size()) {
+				return end();
+			}
+			auto const [first, last] = std::equal_range(dsts_begin(s), dsts_end(s), d);
+			// the weights of the edges from src to dst are sorted too
+			auto const w_first = weights_.begin() + (first - dsts_.begin());
+			auto const w_last = weights_.begin() + (last - dsts_.begin());
+			auto const found = std::lower_bound(w_first, w_last, weight);
+			if (found == w_last or *found != weight) {
+				return end();
+			}
+			return iterator(this, s, static_cast<std::size_t>(found - weights_.begin()));
+		} // O(log(n) + log(d))
+		[[nodiscard]] auto connections(N const& src) const -> std::vector<N> {
+			auto const s = position(src);
+			if (s == nodes_.size()) {
+				throw std::runtime_error("Cannot call gdwg::csr_graph<N, E>::connections if src "
+				                         "doesn't exist in the graph");
+			}
+			auto vec = std::vector<N>{};
+			for (auto iter = dsts_begin(s); iter != dsts_end(s); ++iter) {
+				if (iter == dsts_begin(s) or *iter != *(iter - 1)) { // edges to a dst are adjacent
+					vec.push_back(nodes_[*iter]);
+				}
+			}
+			return vec;
+		} // O(log(n) + d)
+
+		// Range access
+		[[nodiscard]] auto begin() const noexcept -> iterator {
+			// the first edge belongs to the last node whose edges start at 0
+			auto const first = std::upper_bound(offsets_.begin(), offsets_.end(), std::size_t{0});
+			return iterator(this, static_cast<std::size_t>(first - offsets_.begin()) - 1, 0);
+		}
+		[[nodiscard]] auto end() const noexcept -> iterator {
+			return iterator(this, nodes_.size(), dsts_.size());
+		}
+
+	private:
+		std::vector<N> nodes_{}; // sorted, a node is identified by its position here
+		std::vector<std::size_t> offsets_{0};
+		std::vector<std::uint32_t> dsts_{};
+		std::vector<E> weights_{};
+
+		// Returns the position of value in nodes_, or nodes_.size() if it is not a node.
+		[[nodiscard]] auto position(N const& value) const noexcept -> std::size_t {
+			auto const iter = std::lower_bound(nodes_.begin(), nodes_.end(), value);
+			if (iter == nodes_.end() or *iter != value) {
+				return nodes_.size();
+			}
+			return static_cast<std::size_t>(iter - nodes_.begin());
+		}
+		[[nodiscard]] auto dsts_begin(std::size_t src) const noexcept {
+			return dsts_.begin() + static_cast<std::ptrdiff_t>(offsets_[src]);
+		}
+		[[nodiscard]] auto dsts_end(std::size_t src) const noexcept {
+			return dsts_.begin() + static_cast<std::ptrdiff_t>(offsets_[src + 1]);
+		}
+	};
+} // namespace gdwg
+
+#endif // GDWG_CSR_GRAPH_HPP
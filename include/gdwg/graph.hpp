@@ -1,64 +1,792 @@
 #ifndef GDWG_GRAPH_HPP
 #define GDWG_GRAPH_HPP
 
+#include <algorithm>
+#include <atomic>
+#include <bit>
 #include <concepts/concepts.hpp>
 #include <concepts/type_traits.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <initializer_list>
 #include <iterator>
+#include <limits>
 #include <memory>
+#include <memory_resource>
 #include <ostream>
 #include <range/v3/iterator.hpp>
 #include <range/v3/utility.hpp>
 #include <range/v3/utility/common_tuple.hpp>
+#include <range/v3/view/subrange.hpp>
 #include <set>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
+// Nodes are interned: every value is stored once, in a table, and everything else refers to it by
+// its index in that table. Edges are then two ids and a weight, and comparing the nodes of two
+// edges is an id comparison whenever they are the same node.
+enum class node_id : std::uint32_t {};
+// Makes chunk the only owner of what it points to, copying it from resource if another owner
+// shares it. An owner that let go of it in another thread read it before, and the fence orders
+// those reads before the writes that follow.
+template<typename Chunk>
+auto own_chunk(std::shared_ptr<Chunk>& chunk, std::pmr::memory_resource* resource) -> Chunk& {
+	if (chunk.use_count() > 1) {
+		chunk = std::allocate_shared<Chunk>(std::pmr::polymorphic_allocator<Chunk>(resource), *chunk);
+	}
+	else {
+		std::atomic_thread_fence(std::memory_order_acquire);
+	}
+	return *chunk;
+}
+// A table of values by index, kept in chunks of chunk_size of them. Copies of a table share its
+// chunks, and writing to a shared chunk copies that chunk alone first: a copy costs
+// O(size / chunk_size), and the first write to each chunk after it O(chunk_size).
+template<typename T>
+class node_table {
+public:
+	static constexpr auto chunk_bits = std::size_t{8};
+	static constexpr auto chunk_size = std::size_t{1} << chunk_bits;
+
+	explicit node_table(std::pmr::memory_resource* resource)
+	: chunks_{resource}
+	, data_{resource} {}
+	// Shares the chunks of other if they come from resource too, and copies them otherwise.
+	node_table(node_table const& other, std::pmr::memory_resource* resource)
+	: chunks_{resource}
+	, data_{resource}
+	, size_{other.size_} {
+		if (*other.resource() == *resource) {
+			chunks_.assign(other.chunks_.begin(), other.chunks_.end());
+			data_.assign(other.data_.begin(), other.data_.end());
+			return;
+		}
+		chunks_.reserve(other.chunks_.size());
+		data_.reserve(other.chunks_.size());
+		for (auto const& i : other.chunks_) {
+			chunks_.push_back(make_chunk(*i));
+			data_.push_back(chunks_.back()->data());
+		}
+	}
+
+	[[nodiscard]] auto operator[](std::size_t i) const noexcept -> T const& {
+		return data_[i >> chunk_bits][i & (chunk_size - 1)];
+	}
+	[[nodiscard]] auto size() const noexcept -> std::size_t {
+		return size_;
+	}
+	// How many values the list of chunks holds room for, which grows geometrically.
+	[[nodiscard]] auto capacity() const noexcept -> std::size_t {
+		return chunks_.capacity() * chunk_size;
+	}
+
+	// Returns value i to modify, copying its chunk first if another table shares it.
+	auto mutable_at(std::size_t i) -> T& {
+		auto const c = i >> chunk_bits;
+		data_[c] = own_chunk(chunks_[c], resource()).data();
+		return data_[c][i & (chunk_size - 1)];
+	}
+	// Takes U rather than T, so that a copy is only made in the chunk, from its resource.
+	template<typename U>
+	auto push_back(U&& value) -> void {
+		if (chunks_.empty() or chunks_.back()->size() == chunk_size) {
+			auto fresh = make_chunk();
+			fresh->reserve(chunk_size);
+			data_.reserve(chunks_.size() + 1);
+			chunks_.push_back(std::move(fresh));
+			data_.push_back(chunks_.back()->data());
+		}
+		auto& last = own_chunk(chunks_.back(), resource());
+		data_.back() = last.data(); // before the chunk it was copied from can go
+		last.push_back(std::forward<U>(value));
+		data_.back() = last.data();
+		++size_;
+	}
+	// Grows the table to count values, the new ones T{}, unless it holds that many already.
+	auto grow(std::size_t count) -> void {
+		while (size_ < count) {
+			push_back(T{});
+		}
+	}
+
+private:
+	// Every chunk but the last is full. The values are built from the resource of the table.
+	using chunk = std::pmr::vector<T>;
+
+	std::pmr::vector<std::shared_ptr<chunk>> chunks_;
+	std::pmr::vector<T*> data_; // chunks_[i]->data(), saving a load on every lookup
+	std::size_t size_ = 0;
+
+	[[nodiscard]] auto resource() const noexcept -> std::pmr::memory_resource* {
+		return chunks_.get_allocator().resource();
+	}
+	template<typename... Args>
+	[[nodiscard]] auto make_chunk(Args const&... args) const -> std::shared_ptr<chunk> {
+		return std::allocate_shared<chunk>(std::pmr::polymorphic_allocator<chunk>(resource()),
+		                                   args...);
+	}
+};
 template<typename T>
-struct map_compare {
+struct node_lookup {
+	node_table<T> const* values = nullptr;
+	auto value(node_id id) const noexcept -> T const& {
+		return (*values)[static_cast<std::size_t>(id)];
+	}
+};
+// Orders node ids by their values.
+template<typename T>
+struct map_compare : node_lookup<T> {
 	using is_transparent = void;
-	auto operator()(const std::shared_ptr<T>& lhs, const std::shared_ptr<T>& rhs) const -> bool {
-		return *lhs < *rhs;
+	auto operator()(node_id lhs, node_id rhs) const -> bool {
+		return lhs != rhs and this->value(lhs) < this->value(rhs);
 	}
-	auto operator()(const std::shared_ptr<T>& lhs, const T& rhs) const -> bool {
-		return *lhs < rhs;
+	auto operator()(node_id lhs, T const& rhs) const -> bool {
+		return this->value(lhs) < rhs;
 	}
-	auto operator()(const T& lhs, const std::shared_ptr<T>& rhs) const -> bool {
-		return lhs < *rhs;
+	auto operator()(T const& lhs, node_id rhs) const -> bool {
+		return lhs < this->value(rhs);
 	}
 };
-template<typename T, typename S>
+template<typename S>
 struct edge_struct {
-	std::shared_ptr<T> src;
-	std::shared_ptr<T> dst;
-	std::shared_ptr<S> edge;
+	node_id src;
+	node_id dst;
+	S edge;
 };
+// Edges are ordered by (src, dst, edge). They can also be compared with a std::tuple of references
+// to (src, dst, edge), which finds one edge without building an edge_struct, or to a prefix of it:
+// (src, dst) is equivalent to every edge from src to dst, and (src) to every outgoing edge of src.
+// A bare node_id is equivalent to every outgoing edge of that node too.
 template<typename T, typename S>
-struct edge_compare {
-	auto operator()(edge_struct<T, S> const& lhs, edge_struct<T, S> const& rhs) const -> bool {
-		if (*(lhs.src) < *(rhs.src)) {
-			return true;
+struct edge_compare : node_lookup<T> {
+	using is_transparent = void;
+	auto operator()(edge_struct<S> const& lhs, edge_struct<S> const& rhs) const -> bool {
+		if (lhs.src != rhs.src) {
+			return this->value(lhs.src) < this->value(rhs.src);
 		}
-		if (*(lhs.src) == *(rhs.src)) {
-			if (*(lhs.dst) < *(rhs.dst)) {
-				return true;
+		if (lhs.dst != rhs.dst) {
+			return this->value(lhs.dst) < this->value(rhs.dst);
+		}
+		return lhs.edge < rhs.edge;
+	}
+	auto operator()(edge_struct<S> const& lhs, node_id rhs) const -> bool {
+		return lhs.src != rhs and this->value(lhs.src) < this->value(rhs);
+	}
+	auto operator()(node_id lhs, edge_struct<S> const& rhs) const -> bool {
+		return lhs != rhs.src and this->value(lhs) < this->value(rhs.src);
+	}
+	auto operator()(edge_struct<S> const& lhs, std::tuple<T const&> const& rhs) const -> bool {
+		return this->value(lhs.src) < std::get<0>(rhs);
+	}
+	auto operator()(std::tuple<T const&> const& lhs, edge_struct<S> const& rhs) const -> bool {
+		return std::get<0>(lhs) < this->value(rhs.src);
+	}
+	auto operator()(edge_struct<S> const& lhs, std::tuple<T const&, T const&> const& rhs) const
+	   -> bool {
+		return std::tie(this->value(lhs.src), this->value(lhs.dst)) < rhs;
+	}
+	auto operator()(std::tuple<T const&, T const&> const& lhs, edge_struct<S> const& rhs) const
+	   -> bool {
+		return lhs < std::tie(this->value(rhs.src), this->value(rhs.dst));
+	}
+	auto operator()(edge_struct<S> const& lhs,
+	                std::tuple<T const&, T const&, S const&> const& rhs) const -> bool {
+		return std::tie(this->value(lhs.src), this->value(lhs.dst), lhs.edge) < rhs;
+	}
+	auto operator()(std::tuple<T const&, T const&, S const&> const& lhs,
+	                edge_struct<S> const& rhs) const -> bool {
+		return lhs < std::tie(this->value(rhs.src), this->value(rhs.dst), rhs.edge);
+	}
+};
+// The same edges ordered by (dst, src, edge), so that every incoming edge of a node is adjacent.
+template<typename T, typename S>
+struct in_edge_compare : node_lookup<T> {
+	using is_transparent = void;
+	auto operator()(edge_struct<S> const& lhs, edge_struct<S> const& rhs) const -> bool {
+		if (lhs.dst != rhs.dst) {
+			return this->value(lhs.dst) < this->value(rhs.dst);
+		}
+		if (lhs.src != rhs.src) {
+			return this->value(lhs.src) < this->value(rhs.src);
+		}
+		return lhs.edge < rhs.edge;
+	}
+	auto operator()(edge_struct<S> const& lhs, node_id rhs) const -> bool {
+		return lhs.dst != rhs and this->value(lhs.dst) < this->value(rhs);
+	}
+	auto operator()(node_id lhs, edge_struct<S> const& rhs) const -> bool {
+		return lhs != rhs.dst and this->value(lhs) < this->value(rhs.dst);
+	}
+	auto operator()(edge_struct<S> const& lhs, std::tuple<T const&> const& rhs) const -> bool {
+		return this->value(lhs.dst) < std::get<0>(rhs);
+	}
+	auto operator()(std::tuple<T const&> const& lhs, edge_struct<S> const& rhs) const -> bool {
+		return std::get<0>(lhs) < this->value(rhs.dst);
+	}
+};
+// A set kept in a sorted vector, with the parts of the std::set interface that graph uses. Lookups
+// are binary searches over contiguous elements, but inserting or erasing one element moves every
+// element after it, so batches are appended and merged in all at once instead.
+template<typename T, typename Compare>
+class flat_set {
+public:
+	using value_type = T;
+	using key_type = T;
+	using key_compare = Compare;
+	using allocator_type = std::pmr::polymorphic_allocator<T>;
+	using size_type = std::size_t;
+	using const_iterator = typename std::pmr::vector<T>::const_iterator;
+	using iterator = const_iterator;
+
+	flat_set(Compare comp, allocator_type alloc)
+	: comp_{comp}
+	, items_{alloc} {}
+	// Copies the elements of other, which compare through comp from then on.
+	flat_set(flat_set const& other, Compare comp, allocator_type alloc)
+	: comp_{comp}
+	, items_{other.items_, alloc} {}
+
+	[[nodiscard]] auto key_comp() const -> key_compare {
+		return comp_;
+	}
+	[[nodiscard]] auto begin() const noexcept -> const_iterator {
+		return items_.begin();
+	}
+	[[nodiscard]] auto end() const noexcept -> const_iterator {
+		return items_.end();
+	}
+	[[nodiscard]] auto cbegin() const noexcept -> const_iterator {
+		return items_.cbegin();
+	}
+	[[nodiscard]] auto cend() const noexcept -> const_iterator {
+		return items_.cend();
+	}
+	[[nodiscard]] auto size() const noexcept -> size_type {
+		return items_.size();
+	}
+	[[nodiscard]] auto empty() const noexcept -> bool {
+		return items_.empty();
+	}
+
+	template<typename K>
+	[[nodiscard]] auto find(K const& key) const -> const_iterator {
+		auto const iter = lower_bound(key);
+		return iter != end() and !comp_(key, *iter) ? iter : end();
+	}
+	template<typename K>
+	[[nodiscard]] auto lower_bound(K const& key) const -> const_iterator {
+		return std::lower_bound(begin(), end(), key, comp_);
+	}
+	template<typename K>
+	[[nodiscard]] auto equal_range(K const& key) const -> std::pair<const_iterator, const_iterator> {
+		return std::equal_range(begin(), end(), key, comp_);
+	}
+
+	auto insert(T const& value) -> std::pair<iterator, bool> {
+		auto const iter = lower_bound(value);
+		if (iter != end() and !comp_(value, *iter)) {
+			return {iter, false};
+		}
+		return {items_.insert(iter, value), true};
+	} // O(log(size) + size)
+	auto insert(const_iterator hint, T const& value) -> iterator {
+		return emplace_hint(hint, value);
+	}
+	// Appends the range, sorts it and merges it with what was already there, keeping the elements
+	// already there over equivalent ones from the range.
+	template<typename I>
+	auto insert(I first, I last) -> void {
+		auto const old_size = static_cast<std::ptrdiff_t>(items_.size());
+		items_.insert(items_.end(), first, last);
+		auto const middle = items_.begin() + old_size;
+		if (!std::is_sorted(middle, items_.end(), comp_)) { // copies and bulk loads come sorted
+			std::sort(middle, items_.end(), comp_);
+		}
+		if (middle != items_.begin() and middle != items_.end()
+		    and comp_(*middle, *std::prev(middle))) {
+			std::inplace_merge(items_.begin(), middle, items_.end(), comp_);
+		}
+		auto const equivalent = [this](T const& lhs, T const& rhs) { return !comp_(lhs, rhs); };
+		items_.erase(std::unique(items_.begin(), items_.end(), equivalent), items_.end());
+	} // O(size + k log(k)), k is the length of the range
+	auto emplace_hint(const_iterator hint, T const& value) -> iterator {
+		auto const fits = (hint == begin() or comp_(*std::prev(hint), value))
+		                  and (hint == end() or comp_(value, *hint));
+		if (!fits) {
+			hint = lower_bound(value);
+			if (hint != end() and !comp_(value, *hint)) {
+				return hint;
+			}
+		}
+		return items_.insert(hint, value);
+	} // O(1) at the end, O(size) elsewhere
+
+	auto erase(const_iterator pos) -> iterator {
+		return items_.erase(pos);
+	}
+	auto erase(const_iterator first, const_iterator last) -> iterator {
+		return items_.erase(first, last);
+	}
+	template<typename K>
+	auto erase(K const& key) -> size_type {
+		auto const [first, last] = equal_range(key);
+		auto const count = static_cast<size_type>(last - first);
+		items_.erase(first, last);
+		return count;
+	}
+	template<typename Pred>
+	friend auto erase_if(flat_set& set, Pred pred) -> size_type {
+		return static_cast<size_type>(std::erase_if(set.items_, pred));
+	}
+
+private:
+	Compare comp_;
+	std::pmr::vector<T> items_;
+};
+// A set kept in sorted chunks of at most chunk_capacity elements, with the parts of the std::set
+// interface that graph uses. Copies made with a comparator of their own share the chunks, and a
+// write to a shared chunk copies that chunk alone first: a copy costs O(size / chunk_capacity),
+// and the first write to each chunk after it O(chunk_capacity). Lookups binary search the last
+// elements of the chunks, kept side by side, and then one chunk. Inserting or erasing an element
+// moves the elements after it in its own chunk only.
+template<typename T, typename Compare>
+class chunked_set {
+	using chunk = std::pmr::vector<T>;
+	using chunk_ptr = std::shared_ptr<chunk>;
+
+public:
+	using value_type = T;
+	using key_type = T;
+	using key_compare = Compare;
+	using allocator_type = std::pmr::polymorphic_allocator<T>;
+	using size_type = std::size_t;
+	static constexpr auto chunk_capacity = std::max(std::size_t{16}, std::size_t{4096} / sizeof(T));
+
+	class const_iterator {
+	public:
+		using value_type = T;
+		using difference_type = std::ptrdiff_t;
+		using pointer = T const*;
+		using reference = T const&;
+		using iterator_category = std::bidirectional_iterator_tag;
+
+		const_iterator() = default;
+
+		auto operator*() const noexcept -> T const& {
+			return (**chunk_)[pos_];
+		}
+		auto operator->() const noexcept -> T const* {
+			return &**this;
+		}
+		auto operator++() noexcept -> const_iterator& {
+			if (++pos_ == (*chunk_)->size()) {
+				++chunk_;
+				pos_ = 0;
+			}
+			return *this;
+		}
+		auto operator++(int) noexcept -> const_iterator {
+			auto temp = *this;
+			++*this;
+			return temp;
+		}
+		auto operator--() noexcept -> const_iterator& {
+			if (pos_ == 0) {
+				--chunk_;
+				pos_ = (*chunk_)->size();
+			}
+			--pos_;
+			return *this;
+		}
+		auto operator--(int) noexcept -> const_iterator {
+			auto temp = *this;
+			--*this;
+			return temp;
+		}
+		auto operator==(const_iterator const& other) const noexcept -> bool {
+			return chunk_ == other.chunk_ and pos_ == other.pos_;
+		}
+
+	private:
+		friend class chunked_set;
+		chunk_ptr const* chunk_ = nullptr; // end() is the first position past the last chunk
+		std::size_t pos_ = 0;
+
+		const_iterator(chunk_ptr const* chunk, std::size_t pos) noexcept
+		: chunk_{chunk}
+		, pos_{pos} {}
+	};
+	using iterator = const_iterator;
+
+	chunked_set(Compare comp, allocator_type alloc)
+	: comp_{comp}
+	, chunks_{alloc}
+	, lasts_{alloc} {}
+	// Shares the chunks of other if they come from the same resource, and copies them otherwise.
+	// The elements compare through comp from then on.
+	chunked_set(chunked_set const& other, Compare comp, allocator_type alloc)
+	: comp_{comp}
+	, chunks_{alloc}
+	, lasts_{other.lasts_, alloc}
+	, size_{other.size_} {
+		if (*other.resource() == *resource()) {
+			chunks_.assign(other.chunks_.begin(), other.chunks_.end());
+			return;
+		}
+		chunks_.reserve(other.chunks_.size());
+		for (auto const& i : other.chunks_) {
+			chunks_.push_back(make_chunk(*i));
+		}
+	} // O(size / chunk_capacity), or O(size) from another resource
+
+	[[nodiscard]] auto key_comp() const -> key_compare {
+		return comp_;
+	}
+	[[nodiscard]] auto begin() const noexcept -> const_iterator {
+		return at(0, 0);
+	}
+	[[nodiscard]] auto end() const noexcept -> const_iterator {
+		return at(chunks_.size(), 0);
+	}
+	[[nodiscard]] auto cbegin() const noexcept -> const_iterator {
+		return begin();
+	}
+	[[nodiscard]] auto cend() const noexcept -> const_iterator {
+		return end();
+	}
+	[[nodiscard]] auto size() const noexcept -> size_type {
+		return size_;
+	}
+	[[nodiscard]] auto empty() const noexcept -> bool {
+		return size_ == 0;
+	}
+
+	template<typename K>
+	[[nodiscard]] auto find(K const& key) const -> const_iterator {
+		auto const iter = lower_bound(key);
+		return iter != end() and !comp_(key, *iter) ? iter : end();
+	}
+	template<typename K>
+	[[nodiscard]] auto lower_bound(K const& key) const -> const_iterator {
+		// the first chunk whose last element is not before key holds the answer
+		auto const c = static_cast<std::size_t>(
+		   std::lower_bound(lasts_.begin(), lasts_.end(), key, comp_) - lasts_.begin());
+		if (c == chunks_.size()) {
+			return end();
+		}
+		auto const& items = *chunks_[c];
+		auto const pos = std::lower_bound(items.begin(), items.end(), key, comp_) - items.begin();
+		return at(c, static_cast<std::size_t>(pos));
+	} // O(log(size))
+	template<typename K>
+	[[nodiscard]] auto upper_bound(K const& key) const -> const_iterator {
+		auto const c = static_cast<std::size_t>(
+		   std::upper_bound(lasts_.begin(), lasts_.end(), key, comp_) - lasts_.begin());
+		if (c == chunks_.size()) {
+			return end();
+		}
+		auto const& items = *chunks_[c];
+		auto const pos = std::upper_bound(items.begin(), items.end(), key, comp_) - items.begin();
+		return at(c, static_cast<std::size_t>(pos));
+	} // O(log(size))
+	template<typename K>
+	[[nodiscard]] auto equal_range(K const& key) const -> std::pair<const_iterator, const_iterator> {
+		return {lower_bound(key), upper_bound(key)};
+	} // O(log(size))
+
+	auto insert(T const& value) -> std::pair<iterator, bool> {
+		auto const iter = lower_bound(value);
+		if (iter != end() and !comp_(value, *iter)) {
+			return {iter, false};
+		}
+		return {insert_before(iter, value), true};
+	} // O(log(size) + chunk_capacity)
+	auto insert(const_iterator hint, T const& value) -> iterator {
+		return emplace_hint(hint, value);
+	}
+	auto emplace_hint(const_iterator hint, T const& value) -> iterator {
+		auto const fits = (hint == begin() or comp_(*std::prev(hint), value))
+		                  and (hint == end() or comp_(value, *hint));
+		if (!fits) {
+			return insert(value).first;
+		}
+		return insert_before(hint, value);
+	} // O(chunk_capacity) when value belongs at hint, O(log(size) + chunk_capacity) elsewhere
+
+	auto erase(const_iterator pos) -> iterator {
+		auto const c = index(pos);
+		auto& items = own(c);
+		items.erase(items.begin() + static_cast<std::ptrdiff_t>(pos.pos_));
+		--size_;
+		return settle(c, pos.pos_);
+	} // O(chunk_capacity)
+	auto erase(const_iterator first, const_iterator last) -> iterator {
+		auto const c = index(first);
+		auto const last_c = index(last);
+		if (first == last) {
+			return at(c, first.pos_);
+		}
+		auto& items = own(c);
+		if (c == last_c) {
+			items.erase(items.begin() + static_cast<std::ptrdiff_t>(first.pos_),
+			            items.begin() + static_cast<std::ptrdiff_t>(last.pos_));
+			size_ -= last.pos_ - first.pos_;
+			return settle(c, first.pos_);
+		}
+		// the head of the chunk of last, every chunk in between, and the tail of the chunk of first
+		if (last.pos_ > 0) {
+			auto& tail = own(last_c);
+			tail.erase(tail.begin(), tail.begin() + static_cast<std::ptrdiff_t>(last.pos_));
+			size_ -= last.pos_;
+		}
+		for (auto i = c + 1; i < last_c; ++i) {
+			size_ -= chunks_[i]->size();
+		}
+		chunks_.erase(chunks_.begin() + static_cast<std::ptrdiff_t>(c + 1),
+		              chunks_.begin() + static_cast<std::ptrdiff_t>(last_c));
+		lasts_.erase(lasts_.begin() + static_cast<std::ptrdiff_t>(c + 1),
+		             lasts_.begin() + static_cast<std::ptrdiff_t>(last_c));
+		size_ -= items.size() - first.pos_;
+		items.erase(items.begin() + static_cast<std::ptrdiff_t>(first.pos_), items.end());
+		return settle(c, first.pos_);
+	} // O(k + chunk_capacity), k is the length of the range
+	template<typename K>
+	auto erase(K const& key) -> size_type {
+		auto const [first, last] = equal_range(key);
+		auto const count = static_cast<size_type>(std::distance(first, last));
+		erase(first, last);
+		return count;
+	}
+	// Exchanges the elements of two sets that allocate from the same resource.
+	auto swap(chunked_set& other) noexcept -> void {
+		std::swap(comp_, other.comp_);
+		chunks_.swap(other.chunks_);
+		lasts_.swap(other.lasts_);
+		std::swap(size_, other.size_);
+	}
+	// Copies and rewrites only the chunks that hold an element to erase.
+	template<typename Pred>
+	friend auto erase_if(chunked_set& set, Pred pred) -> size_type {
+		auto const before = set.size_;
+		for (auto c = std::size_t{0}; c < set.chunks_.size(); ++c) {
+			auto const& items = *set.chunks_[c];
+			auto const first = std::find_if(items.begin(), items.end(), pred);
+			if (first != items.end()) {
+				auto const pos = first - items.begin();
+				auto& owned = set.own(c);
+				auto const kept = std::remove_if(owned.begin() + pos, owned.end(), pred);
+				set.size_ -= static_cast<size_type>(owned.end() - kept);
+				owned.erase(kept, owned.end());
+			}
+		}
+		set.compact();
+		return before - set.size_;
+	} // O(size)
+
+private:
+	Compare comp_;
+	std::pmr::vector<chunk_ptr> chunks_; // none of them empty
+	std::pmr::vector<T> lasts_; // the last element of every chunk
+	size_type size_ = 0;
+
+	[[nodiscard]] auto resource() const noexcept -> std::pmr::memory_resource* {
+		return chunks_.get_allocator().resource();
+	}
+	template<typename... Args>
+	[[nodiscard]] auto make_chunk(Args&&... args) const -> chunk_ptr {
+		return std::allocate_shared<chunk>(std::pmr::polymorphic_allocator<chunk>(resource()),
+		                                   std::forward<Args>(args)...);
+	}
+	[[nodiscard]] auto at(std::size_t c, std::size_t pos) const noexcept -> const_iterator {
+		return const_iterator(chunks_.data() + c, pos);
+	}
+	[[nodiscard]] auto index(const_iterator iter) const noexcept -> std::size_t {
+		return static_cast<std::size_t>(iter.chunk_ - chunks_.data());
+	}
+	auto own(std::size_t c) -> chunk& {
+		return own_chunk(chunks_[c], resource());
+	}
+
+	// Inserts value before pos, where it belongs. A full chunk is split in two halves, except
+	// that a value past its end starts a new chunk, so that sorted runs fill their chunks.
+	auto insert_before(const_iterator pos, T const& value) -> iterator {
+		auto c = index(pos);
+		auto offset = pos.pos_;
+		if (c > 0 and offset == 0 and chunks_[c - 1]->size() < chunk_capacity) {
+			--c; // the end of the chunk before has room
+			offset = chunks_[c]->size();
+		}
+		else if (c == chunks_.size() and c > 0) {
+			--c;
+			offset = chunks_[c]->size();
+		}
+		if (c == chunks_.size() or chunks_[c]->size() == chunk_capacity) {
+			chunks_.reserve(chunks_.size() + 1); // nothing below throws once the chunk exists
+			lasts_.reserve(lasts_.size() + 1);
+			if (c == chunks_.size() or offset == chunk_capacity) {
+				c = c == chunks_.size() ? c : c + 1;
+				offset = 0;
+				chunks_.insert(chunks_.begin() + static_cast<std::ptrdiff_t>(c), make_chunk());
+				lasts_.insert(lasts_.begin() + static_cast<std::ptrdiff_t>(c), value);
+			}
+			else {
+				auto& items = own(c);
+				auto const half = static_cast<std::ptrdiff_t>(chunk_capacity / 2);
+				auto upper = make_chunk(std::make_move_iterator(items.begin() + half),
+				                        std::make_move_iterator(items.end()));
+				items.erase(items.begin() + half, items.end());
+				chunks_.insert(chunks_.begin() + static_cast<std::ptrdiff_t>(c + 1), std::move(upper));
+				lasts_.insert(lasts_.begin() + static_cast<std::ptrdiff_t>(c + 1), lasts_[c]);
+				lasts_[c] = items.back();
+				if (offset > chunk_capacity / 2) {
+					++c;
+					offset -= chunk_capacity / 2;
+				}
+			}
+		}
+		auto& items = own(c);
+		items.insert(items.begin() + static_cast<std::ptrdiff_t>(offset), value);
+		lasts_[c] = items.back();
+		++size_;
+		return at(c, offset);
+	} // O(chunk_capacity), and O(size / chunk_capacity) more once every chunk_capacity / 2 inserts
+	// Restores the invariants around chunk c after an erasure from it, and returns the iterator to
+	// the element that followed the erased ones, which is at offset in chunk c. A chunk merges with
+	// a neighbour when the two fit in half a chunk, so chunks stay about a quarter full at least.
+	auto settle(std::size_t c, std::size_t offset) -> iterator {
+		if (chunks_[c]->empty()) {
+			chunks_.erase(chunks_.begin() + static_cast<std::ptrdiff_t>(c));
+			lasts_.erase(lasts_.begin() + static_cast<std::ptrdiff_t>(c));
+			return at(c, 0);
+		}
+		if (c + 1 < chunks_.size() and fits_with_next(c)) {
+			merge_next(c);
+		}
+		if (c > 0 and fits_with_next(c - 1)) {
+			--c;
+			offset += chunks_[c]->size();
+			merge_next(c);
+		}
+		lasts_[c] = chunks_[c]->back();
+		return offset == chunks_[c]->size() ? at(c + 1, 0) : at(c, offset);
+	}
+	[[nodiscard]] auto fits_with_next(std::size_t c) const noexcept -> bool {
+		return chunks_[c]->size() + chunks_[c + 1]->size() <= chunk_capacity / 2;
+	}
+	auto merge_next(std::size_t c) -> void {
+		auto& items = own(c);
+		auto const& next = *chunks_[c + 1];
+		items.insert(items.end(), next.begin(), next.end());
+		chunks_.erase(chunks_.begin() + static_cast<std::ptrdiff_t>(c + 1));
+		lasts_.erase(lasts_.begin() + static_cast<std::ptrdiff_t>(c));
+	}
+	// Drops the chunks erase_if emptied and merges the neighbours that fit in half a chunk.
+	auto compact() -> void {
+		auto kept = std::size_t{0};
+		for (auto c = std::size_t{0}; c < chunks_.size(); ++c) {
+			if (chunks_[c]->empty()) {
+				continue;
+			}
+			if (kept > 0
+			    and chunks_[kept - 1]->size() + chunks_[c]->size() <= chunk_capacity / 2)
+			{
+				auto& items = own(kept - 1);
+				items.insert(items.end(), chunks_[c]->begin(), chunks_[c]->end());
 			}
-			if (*(lhs.dst) == *(rhs.dst)) {
-				return (*(lhs.edge) < *(rhs.edge));
+			else {
+				chunks_[kept++] = std::move(chunks_[c]);
 			}
+			lasts_[kept - 1] = chunks_[kept - 1]->back();
 		}
-		return false;
+		chunks_.erase(chunks_.begin() + static_cast<std::ptrdiff_t>(kept), chunks_.end());
+		lasts_.erase(lasts_.begin() + static_cast<std::ptrdiff_t>(kept), lasts_.end());
 	}
 };
-template<typename T>
-using nodes_set = std::set<std::shared_ptr<T>, map_compare<T>>;
-template<typename T, typename S>
-using edges_set = std::set<edge_struct<T, S>, edge_compare<T, S>>;
+template<typename Storage, typename T>
+using nodes_set = typename Storage::template set<node_id, map_compare<T>>;
+template<typename Storage, typename T, typename S>
+using edges_set = typename Storage::template set<edge_struct<S>, edge_compare<T, S>>;
+template<typename Storage, typename T, typename S>
+using in_edges_set = typename Storage::template set<edge_struct<S>, in_edge_compare<T, S>>;
 namespace gdwg {
-	template<concepts::regular N, concepts::regular E>
+	namespace detail {
+		struct graph_access;
+
+		// The algorithms a bulk load runs, run serially.
+		struct serial_algorithms {
+			template<typename... Args>
+			static auto sort(Args&&... args) -> void {
+				std::sort(std::forward<Args>(args)...);
+			}
+			template<typename... Args>
+			static auto transform(Args&&... args) {
+				return std::transform(std::forward<Args>(args)...);
+			}
+			template<typename... Args>
+			static auto unique(Args&&... args) {
+				return std::unique(std::forward<Args>(args)...);
+			}
+		};
+
+		template<typename T>
+		concept hashable = requires(T const& value) {
+			{ std::hash<T>{}(value) } -> std::convertible_to<std::size_t>;
+		};
+
+		// The finaliser of splitmix64. The fingerprint of a graph is a sum of hashes, and the
+		// standard hashes of numbers are the numbers themselves, so every bit is spread first.
+		[[nodiscard]] constexpr auto mix_hash(std::uint64_t x) noexcept -> std::uint64_t {
+			x = (x ^ (x >> 30U)) * 0xbf58476d1ce4e5b9U;
+			x = (x ^ (x >> 27U)) * 0x94d049bb133111ebU;
+			return x ^ (x >> 31U);
+		}
+		template<typename T>
+		[[nodiscard]] auto hash_value(T const& value) noexcept -> std::uint64_t {
+			return static_cast<std::uint64_t>(std::hash<T>{}(value));
+		}
+	} // namespace detail
+
+	// Storage policies pick the container behind the sorted sets of nodes and edges of a graph.
+	// Every policy keeps the same order and so the same observable behaviour; they differ in cost.
+	// node_based policies keep every element where it was inserted, and local_writes policies
+	// insert or erase one element without touching more than its neighbourhood.
+	// tree_storage uses balanced trees: inserting or erasing one node or edge is O(log).
+	struct tree_storage {
+		static constexpr bool node_based = true;
+		static constexpr bool local_writes = true;
+		template<typename T, typename Compare>
+		using set = std::pmr::set<T, Compare>;
+	};
+	// flat_storage uses sorted vectors, contiguous and cheaper to search and walk, for graphs that
+	// are read far more than written: inserting or erasing one element is O(e), batches and bulk
+	// loads are merged in at once.
+	struct flat_storage {
+		static constexpr bool node_based = false;
+		static constexpr bool local_writes = false;
+		template<typename T, typename Compare>
+		using set = flat_set<T, Compare>;
+	};
+	// chunked_storage uses sorted vectors cut into chunks of a few kilobytes, which copies of a
+	// graph share: the first write after a copy copies the chunks it touches and the lists of
+	// chunks, not every node and edge. Inserting or erasing one element is O(log) plus the moves
+	// within its chunk. concurrent_graph uses it, as every snapshot is a copy.
+	struct chunked_storage {
+		static constexpr bool node_based = false;
+		static constexpr bool local_writes = true;
+		template<typename T, typename Compare>
+		using set = chunked_set<T, Compare>;
+	};
+
+	template<concepts::regular N, concepts::regular E, typename Storage = tree_storage>
 	requires concepts::totally_ordered<N>and concepts::totally_ordered<E> class graph {
 	public:
 		class iterator {
-			using edges_iterator = typename edges_set<N, E>::const_iterator;
+			using edges_iterator = typename edges_set<Storage, N, E>::const_iterator;
 
 		public:
 			using value_type = ranges::common_tuple<N, N, E>;
@@ -68,12 +796,17 @@ namespace gdwg {
 			iterator() = default;
 
 			// Iterator source
-			explicit iterator(edges_iterator begin, edges_iterator end, edges_iterator iter) noexcept
-			: begin_{begin}
+			explicit iterator(node_table<N> const* values,
+			                  edges_iterator begin,
+			                  edges_iterator end,
+			                  edges_iterator iter) noexcept
+			: nodes_{values}
+			, begin_{begin}
 			, end_{end}
 			, iter_{iter} {}
-			auto operator*() const noexcept -> ranges::common_tuple<N const, N const, E const> {
-				return ranges::common_tuple<N, N, E>(*(iter_->src), *(iter_->dst), *(iter_->edge));
+			// refers to the values stored in the graph, nothing is copied
+			auto operator*() const noexcept -> ranges::common_tuple<N const&, N const&, E const&> {
+				return {nodes_.value(iter_->src), nodes_.value(iter_->dst), iter_->edge};
 			}
 			// Iterator traversal
 			// just use the set iterator,it is convenient
@@ -97,89 +830,248 @@ namespace gdwg {
 			}
 			// Iterator comparison
 			auto operator==(iterator const& other) const noexcept -> bool {
+				// both walk the same edges, in the same state, so compare the positions
+				if (begin_ == other.begin_ and end_ == other.end_) {
+					return iter_ == other.iter_;
+				}
 				// consider about the iterator points to the end()
 				if (other.iter_ == other.end_ or iter_ == end_) {
 					return static_cast<bool>(other.iter_ == other.end_ and iter_ == end_);
 				}
-				return static_cast<bool>(*(iter_->src) == *(other.iter_->src)
-				                         and *(iter_->dst) == *(other.iter_->dst)
-				                         and *(iter_->edge) == *(other.iter_->edge));
+				return static_cast<bool>(
+				   nodes_.value(iter_->src) == other.nodes_.value(other.iter_->src)
+				   and nodes_.value(iter_->dst) == other.nodes_.value(other.iter_->dst)
+				   and iter_->edge == other.iter_->edge);
 			}
-			friend class graph<N, E>;
+			friend class graph<N, E, Storage>;
 
 		private:
+			node_lookup<N> nodes_;
 			edges_iterator begin_;
 			edges_iterator end_;
 			edges_iterator iter_;
 		};
+		// Walks the outgoing edges of one node, stopping once on each distinct dst.
+		class connection_iterator {
+			using edges_iterator = typename edges_set<Storage, N, E>::const_iterator;
+
+		public:
+			using value_type = N;
+			using difference_type = std::ptrdiff_t;
+			using iterator_category = std::forward_iterator_tag;
+			connection_iterator() = default;
+			explicit connection_iterator(node_table<N> const* values,
+			                             edges_iterator iter,
+			                             edges_iterator last) noexcept
+			: nodes_{values}
+			, iter_{iter}
+			, last_{last} {}
+			auto operator*() const noexcept -> N const& {
+				return nodes_.value(iter_->dst);
+			}
+			auto operator++() noexcept -> connection_iterator& {
+				auto const dst = iter_->dst;
+				do {
+					++iter_; // edges to the same dst are adjacent, they only differ by weight
+				} while (iter_ != last_ and iter_->dst == dst);
+				return *this;
+			}
+			auto operator++(int) noexcept -> connection_iterator {
+				auto temp = *this;
+				++*this;
+				return temp;
+			}
+			auto operator==(connection_iterator const& other) const noexcept -> bool {
+				return iter_ == other.iter_;
+			}
+
+		private:
+			node_lookup<N> nodes_;
+			edges_iterator iter_;
+			edges_iterator last_;
+		};
+		// Walks the nodes in order, yielding the values stored in the graph.
+		class node_iterator {
+			using nodes_iterator = typename nodes_set<Storage, N>::const_iterator;
+
+		public:
+			using value_type = N;
+			using difference_type = std::ptrdiff_t;
+			using iterator_category = std::bidirectional_iterator_tag;
+			node_iterator() = default;
+			explicit node_iterator(node_table<N> const* values, nodes_iterator iter) noexcept
+			: nodes_{values}
+			, iter_{iter} {}
+			auto operator*() const noexcept -> N const& {
+				return nodes_.value(*iter_);
+			}
+			auto operator++() noexcept -> node_iterator& {
+				++iter_;
+				return *this;
+			}
+			auto operator++(int) noexcept -> node_iterator {
+				auto temp = *this;
+				++*this;
+				return temp;
+			}
+			auto operator--() noexcept -> node_iterator& {
+				--iter_;
+				return *this;
+			}
+			auto operator--(int) noexcept -> node_iterator {
+				auto temp = *this;
+				--*this;
+				return temp;
+			}
+			auto operator==(node_iterator const& other) const noexcept -> bool {
+				return iter_ == other.iter_;
+			}
+
+		private:
+			node_lookup<N> nodes_;
+			nodes_iterator iter_;
+		};
+		// Walks the edges from one src to one dst, yielding the weights stored in the graph.
+		class weight_iterator {
+			using edges_iterator = typename edges_set<Storage, N, E>::const_iterator;
+
+		public:
+			using value_type = E;
+			using difference_type = std::ptrdiff_t;
+			using iterator_category = std::bidirectional_iterator_tag;
+			weight_iterator() = default;
+			explicit weight_iterator(edges_iterator iter) noexcept
+			: iter_{iter} {}
+			auto operator*() const noexcept -> E const& {
+				return iter_->edge;
+			}
+			auto operator++() noexcept -> weight_iterator& {
+				++iter_;
+				return *this;
+			}
+			auto operator++(int) noexcept -> weight_iterator {
+				auto temp = *this;
+				++*this;
+				return temp;
+			}
+			auto operator--() noexcept -> weight_iterator& {
+				--iter_;
+				return *this;
+			}
+			auto operator--(int) noexcept -> weight_iterator {
+				auto temp = *this;
+				--*this;
+				return temp;
+			}
+			auto operator==(weight_iterator const& other) const noexcept -> bool {
+				return iter_ == other.iter_;
+			}
+
+		private:
+			edges_iterator iter_;
+		};
 		struct value_type {
 			N from;
 			N to;
 			E weight;
 		};
 		// Constructors
+		// Every node, edge and container of a graph is allocated from its memory resource, which is
+		// the default resource unless one is given. A graph keeps its resource for life, except that
+		// moving a graph moves its resource along with everything allocated from it.
+		// Copies are snapshots: a copy shares the nodes and edges of the graph it copies, as long as
+		// both use the same resource, until either is modified. The first modifier called on either
+		// graph after that copies what it writes to, and invalidates the iterators of that graph.
+		// With chunked_storage that is the chunks it touches and the lists of chunks; tree_storage
+		// and flat_storage can't share part of a set, and copy all of them once, a deferred deep
+		// copy. A snapshot can be read in another thread while the graph it was copied from is
+		// modified.
 		graph() noexcept = default;
-		graph(std::initializer_list<N> il) noexcept {
+		explicit graph(std::pmr::memory_resource* resource) noexcept
+		: resource_{resource} {}
+		graph(std::initializer_list<N> il,
+		      std::pmr::memory_resource* resource = std::pmr::get_default_resource()) noexcept
+		: resource_{resource} {
 			for (const auto& l : il) {
 				insert_node(l);
 			}
 		}
 		template<ranges::forward_iterator I, ranges::sentinel_for<I> S>
-		requires ranges::indirectly_copyable<I, N*> graph(I first, S last) noexcept {
+		requires ranges::indirectly_copyable<I, N*> graph(
+		   I first,
+		   S last,
+		   std::pmr::memory_resource* resource = std::pmr::get_default_resource()) noexcept
+		: resource_{resource} {
 			for (; !(first == last); ++first) {
 				insert_node(*first);
 			}
 		}
-		template<ranges::forward_iterator I, ranges::sentinel_for<I> S>
-		requires ranges::indirectly_copyable<I, value_type*> graph(I first, S last) noexcept {
+		// Reads the range once, so any input range will do, and then builds the graph in bulk.
+		template<ranges::input_iterator I, ranges::sentinel_for<I> S>
+		requires ranges::indirectly_copyable<I, value_type*> graph(
+		   I first,
+		   S last,
+		   std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+		: resource_{resource} {
+			auto edges = std::vector<value_type>{};
 			for (; first != last; ++first) {
-				auto src = first->from;
-				auto dst = first->to;
-				auto weight = first->weight;
-				insert_node(src); // insert_node will handle duplicate nodes
-				insert_node(dst);
-				inner_insert_edge(src, dst, weight); // inner_insert_edge will handle duplicate edges
+				edges.push_back(*first);
 			}
-		}
+			bulk_load("gdwg::graph<N, E>::graph", edges);
+		} // O(e log(e))
 		graph(graph&& other) noexcept
-		: all_nodes_{std::move(other.all_nodes_)}
-		, all_edges_{std::move(other.all_edges_)} {}
+		: resource_{other.resource_}
+		, storage_{std::move(other.storage_)} {}
 
 		auto operator=(graph&& other) noexcept -> graph& {
-			all_edges_ = std::move(other.all_edges_);
-			all_nodes_ = std::move(other.all_nodes_);
+			resource_ = other.resource_;
+			storage_ = std::move(other.storage_);
 			return *this;
 		}
-		graph(graph const& other) noexcept {
+		// Like the standard containers, a copy uses the default resource unless it is given one. It
+		// shares the storage of other if their resources are equal, and copies it, which may throw
+		// std::bad_alloc, if not.
+		graph(graph const& other) {
+			*this = other;
+		}
+		graph(graph const& other, std::pmr::memory_resource* resource)
+		: resource_{resource} {
 			*this = other;
 		}
 		auto operator=(graph const& other) -> graph& {
 			if (this != &other) {
-				for (auto& i : other.all_nodes_) {
-					auto tmp = std::make_shared<N>(*i); // make new entities of edge
-					static_assert(std::is_same_v<decltype(tmp), std::shared_ptr<N>>);
-					all_nodes_.emplace(std::move(tmp));
-				}
-				for (auto& i : other.all_edges_) {
-					auto src = *(all_nodes_.find(i.src)); // find node entities in the nodes set
-					auto dst = *(all_nodes_.find(i.dst));
-					auto edge = std::make_shared<E>(*(i.edge)); // make new entities of edge
-					static_assert(std::is_same_v<decltype(edge), std::shared_ptr<E>>);
-					edge_struct<N, E> edge_struct{src, dst, edge};
-					all_edges_.emplace(edge_struct);
-				}
+				// a graph only shares storage allocated from its own resource
+				storage_ = other.storage_ and *resource_ != *other.resource_
+				              ? make_storage(*other.storage_)
+				              : other.storage_;
 			}
 			return *this;
-		}
+		} // O(1), or O(n + e) when the resources differ
 
 		// Modifiers
 		auto insert_node(N const& value) -> bool {
 			if (is_node(value)) { // will not insert duplicate nodes
 				return false;
 			}
-			auto node = std::make_shared<N>(value);
-			static_assert(std::is_same_v<decltype(node), std::shared_ptr<N>>);
-			all_nodes_.emplace(node);
+			auto& data = mutable_data();
+			auto id = node_id{};
+			if (data.free_ids.empty()) {
+				if (data.values.size() > std::numeric_limits<std::uint32_t>::max()) {
+					throw std::length_error("Cannot call gdwg::graph<N, E>::insert_node when the graph "
+					                        "already has 2^32 nodes");
+				}
+				id = static_cast<node_id>(data.values.size());
+				data.reserve_degrees(data.values.size() + 1);
+				data.values.push_back(value);
+				data.reserve_free_ids();
+			}
+			else {
+				id = data.free_ids.back(); // reuse the slot of an erased node
+				data.values.mutable_at(static_cast<std::size_t>(id)) = value;
+				data.free_ids.pop_back();
+			}
+			data.all_nodes.insert(id);
+			data.fingerprint += data.hash(id);
 			return true;
 		}
 		auto insert_edge(N const& src, N const& dst, E const& weight) -> bool {
@@ -197,105 +1089,335 @@ namespace gdwg {
 			if (is_node(new_data)) {
 				return false;
 			}
-			**(all_nodes_.find(old_data)) = new_data; // just modify the entity's value
-			auto tmp1 = all_nodes_; // copy constructor will resort the set, it is an easy way
-			auto tmp2 = all_edges_;
-			all_nodes_ = std::move(tmp1);
-			all_edges_ = std::move(tmp2);
+			auto value = new_data; // the steps that may throw come first
+			auto& data = mutable_data();
+			auto const node_iter = data.all_nodes.find(old_data);
+			auto const id = *node_iter;
+			auto& slot = data.values.mutable_at(static_cast<std::size_t>(id));
+			// Everything keyed by the old value leaves the sets before the value changes, and goes
+			// back in after it, so the sets are never out of order.
+			if constexpr (Storage::node_based) {
+				// Node handles keep the elements themselves, nothing is copied or allocated.
+				auto const [out_first, out_last] = data.all_edges.equal_range(id);
+				auto const [in_first, in_last] = data.in_edges.equal_range(id);
+				auto const degree = static_cast<std::size_t>(std::distance(out_first, out_last)
+				                                             + std::distance(in_first, in_last));
+				auto edge_handles = std::vector<typename edges_set<Storage, N, E>::node_type>{};
+				auto in_edge_handles = std::vector<typename in_edges_set<Storage, N, E>::node_type>{};
+				edge_handles.reserve(degree);
+				in_edge_handles.reserve(degree);
+				for (auto iter = out_first; iter != out_last;) {
+					in_edge_handles.push_back(data.in_edges.extract(*iter));
+					edge_handles.push_back(data.all_edges.extract(iter++));
+				}
+				// reflexive edges were outgoing edges too, so they are already gone from in_edges
+				for (auto [first, last] = data.in_edges.equal_range(id); first != last;) {
+					edge_handles.push_back(data.all_edges.extract(*first));
+					in_edge_handles.push_back(data.in_edges.extract(first++));
+				}
+				auto node_handle = data.all_nodes.extract(node_iter);
+				data.fingerprint -= rehash(data, id, edge_handles);
+				slot = std::move(value);
+				data.fingerprint += rehash(data, id, edge_handles);
+				data.all_nodes.insert(std::move(node_handle));
+				for (auto& i : edge_handles) {
+					data.all_edges.insert(std::move(i));
+				}
+				for (auto& i : in_edge_handles) {
+					data.in_edges.insert(std::move(i));
+				}
+			}
+			else if constexpr (Storage::local_writes) {
+				// The edges of the node go out and back in one at a time, on copies of the sets that
+				// share their chunks and copy the ones they write to. The sets only take the copies
+				// once nothing is left to allocate, so running out of memory changes nothing.
+				auto node_set = storage::copy_set(data.all_nodes, data.all_nodes.key_comp(), resource_);
+				auto out_set = storage::copy_set(data.all_edges, data.all_edges.key_comp(), resource_);
+				auto in_set = storage::copy_set(data.in_edges, data.in_edges.key_comp(), resource_);
+				auto edges = std::vector<edge_struct<E>>{};
+				edges.reserve(data.out_degrees[static_cast<std::size_t>(id)]
+				              + data.in_degrees[static_cast<std::size_t>(id)]);
+				auto const [out_first, out_last] = data.all_edges.equal_range(id);
+				edges.assign(out_first, out_last);
+				// reflexive edges were outgoing edges too
+				for (auto [first, last] = data.in_edges.equal_range(id); first != last; ++first) {
+					if (first->src != id) {
+						edges.push_back(*first);
+					}
+				}
+				node_set.erase(node_set.find(old_data));
+				for (auto const& i : edges) {
+					out_set.erase(i);
+					in_set.erase(i);
+				}
+				auto const old_hash = rehash(data, id, edges);
+				std::swap(slot, value); // value keeps the old one, for the sets if an insertion throws
+				try {
+					node_set.insert(id);
+					for (auto const& i : edges) {
+						out_set.insert(i);
+						in_set.insert(i);
+					}
+				} catch (...) {
+					std::swap(slot, value);
+					throw;
+				}
+				data.fingerprint += rehash(data, id, edges) - old_hash;
+				data.all_nodes.swap(node_set);
+				data.all_edges.swap(out_set);
+				data.in_edges.swap(in_set);
+			}
+			else {
+				// one pass takes every edge of the node out, and one merge per set puts them back
+				auto edges = std::vector<edge_struct<E>>{};
+				auto const incident = [id](auto const& edge) {
+					return edge.src == id or edge.dst == id;
+				};
+				std::copy_if(data.all_edges.begin(),
+				             data.all_edges.end(),
+				             std::back_inserter(edges),
+				             incident);
+				data.all_nodes.erase(node_iter);
+				erase_if(data.all_edges, incident);
+				erase_if(data.in_edges, incident);
+				data.fingerprint -= rehash(data, id, edges);
+				slot = std::move(value);
+				data.fingerprint += rehash(data, id, edges);
+				data.all_nodes.insert(id);
+				data.all_edges.insert(edges.begin(), edges.end());
+				data.in_edges.insert(edges.begin(), edges.end());
+			}
 			return true;
-		}
+		} // O(log(n) + d log(e)), d is the degree of old_data, O(n + e) with flat_storage, and
+		  // O(log(n) + d log(e) + (n + e) / c) with chunked_storage, c elements to a chunk
 		auto merge_replace_node(N const& old_data, N const& new_data) -> void {
 			if (!is_node(old_data) or !is_node(new_data)) {
 				throw std::runtime_error("Cannot call comp6771::graph<N, E>::merge_replace_node on old "
 				                         "or new data if they don't exist in the graph");
 			}
-			all_nodes_.erase(all_nodes_.find(old_data)); // erase old nodes in nodes set
-			auto new_ptr = *(all_nodes_.find(new_data));
-			// create a new edge set, because copying value to shared_ptr in struct has some problems
-			auto new_edges_set = decltype(all_edges_){};
-			edge_struct<N, E> tmp{};
-			for (auto& i : all_edges_) {
-				tmp.src = *(i.src) == old_data ? new_ptr : i.src; // change old value to new
-				tmp.dst = *(i.dst) == old_data ? new_ptr : i.dst;
-				tmp.edge = i.edge;
-				new_edges_set.emplace(tmp);
-			}
-			all_edges_ = std::move(new_edges_set);
-		}
-		auto erase_node(N const& value) noexcept -> bool {
-			auto iter = all_nodes_.find(value);
-			if (iter == all_nodes_.end()) {
-				return false;
+			auto const& data = get_data();
+			auto const old_id = *(data.all_nodes.find(old_data));
+			auto const new_id = *(data.all_nodes.find(new_data));
+			if (old_id == new_id) {
+				return; // merging a node into itself changes nothing
 			}
-			all_nodes_.erase(iter);
-			auto new_edges_set = decltype(all_edges_){};
-			for (auto& i : all_edges_) {
-				if (*(i.src) == value or *(i.dst) == value) {
-					continue; // if the edge has old value, will not add it to new edge set
-				}
-				new_edges_set.emplace(i);
+			// take the old node out with its edges, then put them back with the new node instead
+			auto edges = remove_nodes({old_id}, !Storage::local_writes);
+			for (auto& i : edges) {
+				i.src = i.src == old_id ? new_id : i.src; // change old value to new
+				i.dst = i.dst == old_id ? new_id : i.dst;
+			}
+			insert_new_edges(edges); // duplicate edges are dropped here
+		} // O(d log(e)), d is the degree of old_data, O(d log(e) + (n + e) / c) with chunked_storage
+		// Running out of memory throws std::bad_alloc, and leaves the graph as it was.
+		auto erase_node(N const& value) -> bool {
+			if (!is_node(value)) {
+				return false;
 			}
-			all_edges_ = std::move(new_edges_set);
+			// value may refer into the node table, it is not read again
+			auto const id = *(get_data().all_nodes.find(value));
+			remove_nodes({id}, !Storage::local_writes);
 			return true;
-		} // O(log(n) + e)
+		} // O(log(n) + d log(e)), d is the degree of value, O(log(n) + d log(e) + (n + e) / c) with
+		  // chunked_storage
 		auto erase_edge(N const& src, N const& dst, E const& weight) -> bool // O(log(n) + e)
 		{
 			if (!is_node(src) or !is_node(dst)) {
 				throw std::runtime_error("Cannot call comp6771::graph<N, E>::erase_edge on src or dst "
 				                         "if they don't exist in the graph");
 			}
-			edge_struct<N, E> value{std::make_shared<N>(src),
-			                        std::make_shared<N>(dst),
-			                        std::make_shared<E>(weight)};
-			static_assert(std::is_same_v<decltype(value.src), std::shared_ptr<N>>);
-			static_assert(std::is_same_v<decltype(value.dst), std::shared_ptr<N>>);
-			static_assert(std::is_same_v<decltype(value.edge), std::shared_ptr<E>>);
-			auto iter = all_edges_.find(value);
-			if (iter != all_edges_.end()) {
-				all_edges_.erase(iter);
+			auto& data = mutable_data();
+			auto iter = data.all_edges.find(std::tie(src, dst, weight)); // no edge_struct to allocate
+			if (iter != data.all_edges.end()) {
+				data.removed(*iter);
+				data.in_edges.erase(*iter);
+				data.all_edges.erase(iter);
 				return true;
 			}
 			return false;
 		}
-		auto erase_edge(iterator i) noexcept -> iterator {
+		auto erase_edge(iterator i) -> iterator {
 			if (i == end()) {
 				return end();
 			}
+			auto& data = mutable_data(i);
+			data.removed(*(i.iter_));
+			data.in_edges.erase(*(i.iter_));
 			// use set erase method, easy!
-			return iterator(all_edges_.begin(), all_edges_.end(), all_edges_.erase(i.iter_));
-		} // Amortised constant time.
-		auto erase_edge(iterator i, iterator s) noexcept -> iterator {
+			return make_iterator(data.all_edges.erase(i.iter_));
+		} // O(log(e)), keeping the incoming index in sync
+		auto erase_edge(iterator i, iterator s) -> iterator {
 			if (s == end()) {
 				return end();
 			}
+			auto& data = mutable_data(i, s);
+			for (auto iter = i.iter_; iter != s.iter_; ++iter) {
+				data.removed(*iter);
+			}
+			if constexpr (Storage::local_writes) {
+				for (auto iter = i.iter_; iter != s.iter_; ++iter) {
+					data.in_edges.erase(*iter);
+				}
+			}
+			else if (i.iter_ != s.iter_) {
+				// the erased edges are the ones between *i and *s in the order of all_edges
+				auto const comp = data.all_edges.key_comp();
+				erase_if(data.in_edges, [&comp, &i, &s](auto const& edge) {
+					return !comp(edge, *i.iter_) and comp(edge, *s.iter_);
+				});
+			}
 			// use set erase method, easy!
-			return iterator(all_edges_.begin(), all_edges_.end(), all_edges_.erase(i.iter_, s.iter_));
-		} // O(d)
+			return make_iterator(data.all_edges.erase(i.iter_, s.iter_));
+		} // O(d log(e))
+		// Batch modifiers: each one checks the whole batch before touching the graph, so a batch that
+		// throws changes nothing.
+		// Inserts every edge of the range and returns how many of them were not already there.
+		template<ranges::input_iterator I, ranges::sentinel_for<I> S>
+		requires ranges::indirectly_copyable<I, value_type*> auto insert_edges(I first, S last)
+		   -> std::size_t {
+			auto const& nodes = get_data().all_nodes;
+			auto batch = std::vector<edge_struct<E>>{};
+			for (; first != last; ++first) {
+				value_type const edge = *first;
+				auto const src = nodes.find(edge.from);
+				auto const dst = nodes.find(edge.to);
+				if (src == nodes.end() or dst == nodes.end()) {
+					throw std::runtime_error("Cannot call gdwg::graph<N, E>::insert_edges when either "
+					                         "src or dst node does not exist");
+				}
+				batch.push_back({*src, *dst, edge.weight});
+			}
+			return batch.empty() ? 0 : insert_new_edges(batch);
+		} // O(k log(k) + k log(e)), and about O(k log(k) + k) when the batch falls in few places
+		// Erases every edge of the range that is in the graph and returns how many were.
+		template<ranges::input_iterator I, ranges::sentinel_for<I> S>
+		requires ranges::indirectly_copyable<I, value_type*> auto erase_edges(I first, S last)
+		   -> std::size_t {
+			auto batch = std::vector<value_type>{};
+			for (; first != last; ++first) {
+				batch.push_back(*first);
+				if (!is_node(batch.back().from) or !is_node(batch.back().to)) {
+					throw std::runtime_error("Cannot call comp6771::graph<N, E>::erase_edges on src or "
+					                         "dst if they don't exist in the graph");
+				}
+			}
+			if (batch.empty()) {
+				return 0;
+			}
+			auto& data = mutable_data();
+			if constexpr (!Storage::local_writes) {
+				// find the edges first, then take them all out of each vector in a single pass
+				auto doomed = std::vector<edge_struct<E>>{};
+				for (auto const& i : batch) {
+					auto iter = data.all_edges.find(std::tie(i.from, i.to, i.weight));
+					if (iter != data.all_edges.end()) {
+						doomed.push_back(*iter);
+					}
+				}
+				auto const comp = data.all_edges.key_comp();
+				std::sort(doomed.begin(), doomed.end(), comp);
+				auto const equivalent = [&comp](auto const& lhs, auto const& rhs) {
+					return !comp(lhs, rhs);
+				};
+				doomed.erase(std::unique(doomed.begin(), doomed.end(), equivalent), doomed.end());
+				for (auto const& i : doomed) {
+					data.removed(i);
+				}
+				auto const is_doomed = [&doomed, &comp](auto const& edge) {
+					return std::binary_search(doomed.begin(), doomed.end(), edge, comp);
+				};
+				erase_if(data.all_edges, is_doomed);
+				return erase_if(data.in_edges, is_doomed);
+			}
+			auto erased = std::size_t{0};
+			for (auto const& i : batch) {
+				auto iter = data.all_edges.find(std::tie(i.from, i.to, i.weight));
+				if (iter != data.all_edges.end()) {
+					data.removed(*iter);
+					data.in_edges.erase(*iter);
+					data.all_edges.erase(iter);
+					++erased;
+				}
+			}
+			return erased;
+		} // O(k log(n) + k log(e)), or O(k log(n) + e log(k)) with flat_storage
+		// Erases every node of the range that is in the graph, with all of their edges, and returns
+		// how many were.
+		template<ranges::input_iterator I, ranges::sentinel_for<I> S>
+		requires ranges::indirectly_copyable<I, N*> auto erase_nodes(I first, S last)
+		   -> std::size_t {
+			auto const& nodes = get_data().all_nodes;
+			auto victims = std::vector<node_id>{};
+			for (; first != last; ++first) {
+				N const& value = *first;
+				if (auto const iter = nodes.find(value); iter != nodes.end()) {
+					victims.push_back(*iter);
+				}
+			}
+			std::sort(victims.begin(), victims.end());
+			victims.erase(std::unique(victims.begin(), victims.end()), victims.end());
+			if (victims.empty()) {
+				return 0;
+			}
+			auto const& data = get_data();
+			// Removing the edges node by node costs O(log(e)) per edge, sweeping the edge sets once
+			// costs O(1) per edge of the graph, so sweep when the victims own enough of the edges.
+			// flat_storage always sweeps, it cannot erase one edge for less than a sweep.
+			auto degrees = std::size_t{0};
+			for (auto const id : victims) {
+				auto const [out_first, out_last] = data.all_edges.equal_range(id);
+				auto const [in_first, in_last] = data.in_edges.equal_range(id);
+				degrees += static_cast<std::size_t>(std::distance(out_first, out_last)
+				                                    + std::distance(in_first, in_last));
+			}
+			auto const total = data.all_edges.size();
+			remove_nodes(victims,
+			             !Storage::local_writes
+			                or degrees * static_cast<std::size_t>(std::bit_width(total)) > total);
+			return victims.size();
+		} // O(k log(n) + min(d log(e), e)), d is the total degree of the erased nodes
 		auto clear() noexcept -> void {
-			all_edges_.clear();
-			all_nodes_.clear();
+			storage_.reset();
 		}
 
 		// Accessors
+		[[nodiscard]] auto resource() const noexcept -> std::pmr::memory_resource* {
+			return resource_;
+		}
 		[[nodiscard]] auto is_node(N const& value) const noexcept -> bool {
-			return static_cast<bool>(all_nodes_.find(value) != all_nodes_.end());
+			auto const& data = get_data();
+			return static_cast<bool>(data.all_nodes.find(value) != data.all_nodes.end());
 		}
 		[[nodiscard]] auto empty() const noexcept -> bool {
-			return static_cast<bool>(all_nodes_.size() == 0);
+			return static_cast<bool>(get_data().all_nodes.size() == 0);
 		}
+		[[nodiscard]] auto node_count() const noexcept -> std::size_t {
+			return get_data().all_nodes.size();
+		} // O(1)
+		[[nodiscard]] auto edge_count() const noexcept -> std::size_t {
+			return get_data().all_edges.size();
+		} // O(1)
+		// Returns a hash of the nodes and edges, which equal graphs share whatever their storage and
+		// the order they were built in. Every modifier keeps it up to date.
+		[[nodiscard]] auto fingerprint() const noexcept -> std::size_t
+		   requires detail::hashable<N> and detail::hashable<E> {
+			return static_cast<std::size_t>(get_data().fingerprint);
+		} // O(1)
 		[[nodiscard]] auto is_connected(N const& src, N const& dst) const -> bool {
 			if (!is_node(src) or !is_node(dst)) {
 				throw std::runtime_error("Cannot call gdwg::graph<N, E>::is_connected if src or dst "
 				                         "node don't exist in the graph");
 			}
-			return std::any_of(all_edges_.begin(), all_edges_.end(), [src, dst](auto i) {
-				return *(i.src) == src and *(i.dst) == dst;
-			});
-		}
+			auto const& data = get_data();
+			auto const key = std::tie(src, dst);
+			auto iter = data.all_edges.lower_bound(key); // the first edge from src to dst, if any
+			return iter != data.all_edges.end() and !data.all_edges.key_comp()(key, *iter);
+		} // O(log(n) + log(e))
 		[[nodiscard]] auto nodes() const noexcept -> std::vector<N> {
+			auto const& data = get_data();
 			std::vector<N> vec{}; // cannot use iterator of set to construct, why errors?
-			for (auto& i : all_nodes_) {
-				vec.emplace_back(*i);
+			for (auto i : data.all_nodes) {
+				vec.emplace_back(data.value(i));
 			}
 			return vec;
 		}; // O(n)
@@ -304,98 +1426,169 @@ namespace gdwg {
 				throw std::runtime_error("Cannot call gdwg::graph<N, E>::weights if src or dst node "
 				                         "don't exist in the graph");
 			}
+			auto [first, last] = get_data().all_edges.equal_range(std::tie(src, dst));
 			std::vector<E> vec{};
-			for (auto& i : all_edges_) {
-				if (*(i.src) == src and *(i.dst) == dst) {
-					vec.emplace_back(*(i.edge));
-				}
+			for (auto iter = first; iter != last; ++iter) {
+				vec.emplace_back(iter->edge);
 			}
 			return vec;
-		} // O(log(n) + e)
+		} // O(log(n) + log(e) + k), k is the number of edges from src to dst
 		[[nodiscard]] auto find(N const& src, N const& dst, E const& weight) const -> iterator {
-			edge_struct<N, E> value{std::make_shared<N>(src),
-			                        std::make_shared<N>(dst),
-			                        std::make_shared<E>(weight)};
-			static_assert(std::is_same_v<decltype(value.src), std::shared_ptr<N>>);
-			static_assert(std::is_same_v<decltype(value.dst), std::shared_ptr<N>>);
-			static_assert(std::is_same_v<decltype(value.edge), std::shared_ptr<E>>);
-			return iterator(all_edges_.begin(), all_edges_.end(), all_edges_.find(value));
-		}
+			return make_iterator(get_data().all_edges.find(std::tie(src, dst, weight)));
+		} // O(log(e)), without any allocation
 		[[nodiscard]] auto connections(N const& src) const -> std::vector<N> {
 			if (!is_node(src)) {
 				throw std::runtime_error("Cannot call gdwg::graph<N, E>::connections if src doesn't "
 				                         "exist in the graph");
 			}
-			auto iter = binary_search(src); // find the edge iterator which has src as from.
+			auto dsts = distinct_dsts(src);
+			return std::vector<N>(dsts.begin(), dsts.end());
+		} // O(log(n) + log(e) + k), k is the number of outgoing edges of src
+		// The same nodes as connections(src), read in place from the edges of src.
+		[[nodiscard]] auto connections_view(N const& src) const
+		   -> ranges::subrange<connection_iterator> {
+			if (!is_node(src)) {
+				throw std::runtime_error("Cannot call gdwg::graph<N, E>::connections_view if src "
+				                         "doesn't exist in the graph");
+			}
+			return distinct_dsts(src);
+		} // O(log(n) + log(e)), the view is invalidated like any iterator
+		// The same nodes as nodes(), read in place.
+		[[nodiscard]] auto nodes_view() const noexcept -> ranges::subrange<node_iterator> {
+			auto const& data = get_data();
+			return {node_iterator(&data.values, data.all_nodes.begin()),
+			        node_iterator(&data.values, data.all_nodes.end())};
+		} // O(1), the view is invalidated like any iterator
+		// Every edge from src, in the order of the graph's own iteration.
+		[[nodiscard]] auto out_edges(N const& src) const -> ranges::subrange<iterator> {
+			if (!is_node(src)) {
+				throw std::runtime_error("Cannot call gdwg::graph<N, E>::out_edges if src doesn't "
+				                         "exist in the graph");
+			}
+			auto [first, last] = get_data().all_edges.equal_range(std::tie(src));
+			return {make_iterator(first), make_iterator(last)};
+		} // O(log(n) + log(e)), the view is invalidated like any iterator
+		// The same weights as weights(src, dst), read in place.
+		[[nodiscard]] auto weights_view(N const& src, N const& dst) const
+		   -> ranges::subrange<weight_iterator> {
+			if (!is_node(src) or !is_node(dst)) {
+				throw std::runtime_error("Cannot call gdwg::graph<N, E>::weights_view if src or dst "
+				                         "node don't exist in the graph");
+			}
+			auto [first, last] = get_data().all_edges.equal_range(std::tie(src, dst));
+			return {weight_iterator(first), weight_iterator(last)};
+		} // O(log(n) + log(e)), the view is invalidated like any iterator
+		// Returns the nodes with an edge to dst, in order.
+		[[nodiscard]] auto predecessors(N const& dst) const -> std::vector<N> {
+			if (!is_node(dst)) {
+				throw std::runtime_error("Cannot call gdwg::graph<N, E>::predecessors if dst doesn't "
+				                         "exist in the graph");
+			}
+			auto const& data = get_data();
+			auto [first, last] = data.in_edges.equal_range(std::tie(dst));
 			std::vector<N> vec{};
-			if (iter == all_edges_.end()) {
-				return vec;
-			}
-			auto tmp = iter;
-			vec.emplace_back(*(iter->dst));
-			while (tmp != all_edges_.begin() and *(tmp->src) == src) {
-				--tmp;
-				if (*(tmp->dst) != vec.back()) {
-					vec.emplace_back(*(tmp->dst));
-				}
-			} // O(e)
-			std::reverse(vec.begin(), vec.end()); // O(e)
-			tmp = ++iter;
-			while (tmp != all_edges_.end() and *(tmp->src) == src) {
-				if (*(tmp->dst) != vec.back()) {
-					vec.emplace_back(*(tmp->dst));
-				}
-				++tmp;
-			} // O(e)
+			for (auto iter = first; iter != last; ++iter) {
+				// the edges from one src are adjacent, they only differ by weight
+				if (iter == first or iter->src != std::prev(iter)->src) {
+					vec.emplace_back(data.value(iter->src));
+				}
+			}
+			return vec;
+		} // O(log(n) + log(e) + k), k is the number of incoming edges of dst
+		// Returns the number of edges from src, which every modifier keeps count of.
+		[[nodiscard]] auto out_degree(N const& src) const -> std::size_t {
+			auto const& data = get_data();
+			auto const iter = data.all_nodes.find(src);
+			if (iter == data.all_nodes.end()) {
+				throw std::runtime_error("Cannot call gdwg::graph<N, E>::out_degree if src doesn't "
+				                         "exist in the graph");
+			}
+			return data.out_degrees[static_cast<std::size_t>(*iter)];
+		} // O(log(n))
+		// Returns the number of edges to dst, which every modifier keeps count of.
+		[[nodiscard]] auto in_degree(N const& dst) const -> std::size_t {
+			auto const& data = get_data();
+			auto const iter = data.all_nodes.find(dst);
+			if (iter == data.all_nodes.end()) {
+				throw std::runtime_error("Cannot call gdwg::graph<N, E>::in_degree if dst doesn't "
+				                         "exist in the graph");
+			}
+			return data.in_degrees[static_cast<std::size_t>(*iter)];
+		} // O(log(n))
+		// Returns the edges to dst, ordered by src and then by weight.
+		[[nodiscard]] auto in_edges(N const& dst) const -> std::vector<value_type> {
+			if (!is_node(dst)) {
+				throw std::runtime_error("Cannot call gdwg::graph<N, E>::in_edges if dst doesn't "
+				                         "exist in the graph");
+			}
+			auto const& data = get_data();
+			auto [first, last] = data.in_edges.equal_range(std::tie(dst));
+			std::vector<value_type> vec{};
+			for (auto iter = first; iter != last; ++iter) {
+				vec.push_back({data.value(iter->src), dst, iter->edge});
+			}
 			return vec;
-		} // O(log(n) + e)
+		} // O(log(n) + log(e) + k)
 
 		// Range access
 		[[nodiscard]] auto begin() const noexcept -> iterator {
-			return iterator(all_edges_.begin(), all_edges_.end(), all_edges_.begin());
+			return make_iterator(get_data().all_edges.begin());
 		}
 		[[nodiscard]] auto end() const noexcept -> iterator {
-			return iterator(all_edges_.begin(), all_edges_.end(), all_edges_.end());
+			return make_iterator(get_data().all_edges.end());
 		}
 
 		// Comparisons
 		[[nodiscard]] auto operator==(graph const& other) const noexcept -> bool {
-			// compare nodes set
-			auto it_1 = all_nodes_.begin();
-			auto it_2 = other.all_nodes_.begin();
-			while (it_1 != all_nodes_.end() and it_2 != other.all_nodes_.end()) {
-				if (**it_1 != **it_2) {
-					return false;
-				}
-				it_1++;
-				it_2++;
+			if (storage_ == other.storage_) { // a snapshot and the graph it was copied from
+				return true;
 			}
-			if (it_1 != all_nodes_.end() or it_2 != other.all_nodes_.end()) {
+			auto const& lhs = get_data();
+			auto const& rhs = other.get_data();
+			// the sizes of the sets and the fingerprints are at hand, and graphs that differ almost
+			// always differ in one of them (the fingerprints are 0 when N or E can't be hashed)
+			if (lhs.all_nodes.size() != rhs.all_nodes.size()
+			    or lhs.all_edges.size() != rhs.all_edges.size() or lhs.fingerprint != rhs.fingerprint)
+			{
 				return false;
 			}
-			// compare edges set
-			auto it_3 = all_edges_.begin();
-			auto it_4 = other.all_edges_.begin();
-			while (it_3 != all_edges_.end() and it_4 != other.all_edges_.end()) {
-				if (*(it_3->src) != *(it_4->src) and *(it_3->dst) != *(it_4->dst)
-				    and *(it_3->edge) != *(it_4->edge))
-				{
+			auto same_ids = true;
+			auto rhs_node = rhs.all_nodes.begin();
+			for (auto const id : lhs.all_nodes) {
+				if (lhs.value(id) != rhs.value(*rhs_node)) {
 					return false;
 				}
-				it_3++;
-				it_4++;
+				same_ids = same_ids and id == *rhs_node;
+				++rhs_node;
+			}
+			// Graphs built or modified alike give their nodes the same ids. Then an edge is equal to
+			// another when their ids are, and the edges compare without looking up any node.
+			if (same_ids) {
+				return std::equal(lhs.all_edges.begin(),
+				                  lhs.all_edges.end(),
+				                  rhs.all_edges.begin(),
+				                  [](edge_struct<E> const& x, edge_struct<E> const& y) {
+					                  return x.src == y.src and x.dst == y.dst and x.edge == y.edge;
+				                  });
 			}
-			return !static_cast<bool>(it_3 != all_edges_.end() or it_4 != other.all_edges_.end());
+			return std::equal(lhs.all_edges.begin(),
+			                  lhs.all_edges.end(),
+			                  rhs.all_edges.begin(),
+			                  [&lhs, &rhs](edge_struct<E> const& x, edge_struct<E> const& y) {
+				                  return lhs.value(x.src) == rhs.value(y.src)
+				                         and lhs.value(x.dst) == rhs.value(y.dst) and x.edge == y.edge;
+			                  });
 		} // O(n + e)
 
 		// Extractor
 		friend auto operator<<(std::ostream& os, graph const& g) noexcept -> std::ostream& {
-			auto it_1 = g.all_nodes_.begin();
-			auto it_2 = g.all_edges_.begin();
-			while (it_1 != g.all_nodes_.end()) {
-				os << **it_1 << " (\n";
-				while (it_2 != g.all_edges_.end() and *(it_2->src) == **it_1) {
-					os << "  " << *(it_2->dst) << " | " << *(it_2->edge) << "\n";
+			auto const& data = g.get_data();
+			auto it_1 = data.all_nodes.begin();
+			auto it_2 = data.all_edges.begin();
+			while (it_1 != data.all_nodes.end()) {
+				os << data.value(*it_1) << " (\n";
+				while (it_2 != data.all_edges.end() and it_2->src == *it_1) {
+					os << "  " << data.value(it_2->dst) << " | " << it_2->edge << "\n";
 					it_2++;
 				}
 				os << ")\n";
@@ -405,44 +1598,547 @@ namespace gdwg {
 		}
 
 	private:
-		nodes_set<N> all_nodes_{};
-		edges_set<N, E> all_edges_{};
+		friend struct detail::graph_access;
+
+		// Everything a graph owns hangs off one block from its memory resource: the comparators point
+		// at its node table, so the block never moves, and moving a graph only moves the pointer to
+		// it. Copies share the block, which is never written while it is shared. A copy of the block
+		// shares the chunks of the tables, and of the sets that are chunked too, with the original.
+		struct storage {
+			node_table<N> values;
+			std::pmr::vector<node_id> free_ids; // slots of erased nodes, reused by insert_node
+			node_table<std::size_t> out_degrees; // by id, 0 for an unused id
+			node_table<std::size_t> in_degrees;
+			nodes_set<Storage, N> all_nodes;
+			edges_set<Storage, N, E> all_edges;
+			in_edges_set<Storage, N, E> in_edges; // grouped by dst
+			std::uint64_t fingerprint = 0; // the sum of hash over every node and edge
+
+			explicit storage(std::pmr::memory_resource* resource)
+			: values{resource}
+			, free_ids{resource}
+			, out_degrees{resource}
+			, in_degrees{resource}
+			, all_nodes{map_compare<N>{{&values}}, resource}
+			, all_edges{edge_compare<N, E>{{&values}}, resource}
+			, in_edges{in_edge_compare<N, E>{{&values}}, resource} {}
+			storage(storage const& other, std::pmr::memory_resource* resource)
+			: values{other.values, resource}
+			, free_ids{other.free_ids, resource}
+			, out_degrees{other.out_degrees, resource}
+			, in_degrees{other.in_degrees, resource}
+			, all_nodes{copy_set(other.all_nodes, map_compare<N>{{&values}}, resource)}
+			, all_edges{copy_set(other.all_edges, edge_compare<N, E>{{&values}}, resource)}
+			, in_edges{copy_set(other.in_edges, in_edge_compare<N, E>{{&values}}, resource)}
+			, fingerprint{other.fingerprint} {
+				reserve_free_ids();
+			}
+			storage(storage&&) = delete;
+			auto operator=(storage const&) -> storage& = delete;
+			auto operator=(storage&&) -> storage& = delete;
+			~storage() = default;
+
+			// The sets of other compare through other.values. A set that can take the elements of
+			// other with a comparator of its own does, and the others are refilled in order.
+			template<typename Set>
+			[[nodiscard]] static auto copy_set(Set const& other,
+			                                   typename Set::key_compare comp,
+			                                   std::pmr::memory_resource* resource) -> Set {
+				if constexpr (std::constructible_from<Set,
+				                                      Set const&,
+				                                      typename Set::key_compare,
+				                                      std::pmr::memory_resource*>)
+				{
+					return Set(other, comp, resource);
+				}
+				else {
+					auto set = Set(comp, resource);
+					set.insert(other.begin(), other.end());
+					return set;
+				}
+			}
+			[[nodiscard]] auto value(node_id id) const noexcept -> N const& {
+				return values[static_cast<std::size_t>(id)];
+			}
+			// The hashes the fingerprint sums, 0 unless N and E are hashable. An edge hashes the
+			// values of its nodes, not their ids, so equal graphs have equal fingerprints.
+			[[nodiscard]] auto hash(node_id id) const noexcept -> std::uint64_t {
+				if constexpr (hashed) {
+					return detail::mix_hash(detail::hash_value(value(id)));
+				}
+				return 0;
+			}
+			[[nodiscard]] auto hash(edge_struct<E> const& edge) const noexcept -> std::uint64_t {
+				if constexpr (hashed) {
+					auto const src = hash(edge.src);
+					auto const dst = detail::hash_value(value(edge.dst));
+					return detail::mix_hash(detail::mix_hash(src + dst) + detail::hash_value(edge.edge));
+				}
+				return 0;
+			}
+			// Counts an edge inserted into the edge sets, or erased from them. Either copies the
+			// chunks of the degrees it changes if they are shared, and changes nothing if that throws.
+			auto added(edge_struct<E> const& edge) -> void {
+				auto& out = out_degrees.mutable_at(static_cast<std::size_t>(edge.src));
+				auto& in = in_degrees.mutable_at(static_cast<std::size_t>(edge.dst));
+				++out;
+				++in;
+				fingerprint += hash(edge);
+			}
+			auto removed(edge_struct<E> const& edge) -> void {
+				auto& out = out_degrees.mutable_at(static_cast<std::size_t>(edge.src));
+				auto& in = in_degrees.mutable_at(static_cast<std::size_t>(edge.dst));
+				--out;
+				--in;
+				fingerprint -= hash(edge);
+			}
+			// Makes room for the degrees of every id below count, before the ids are created.
+			auto reserve_degrees(std::size_t count) -> void {
+				out_degrees.grow(count);
+				in_degrees.grow(count);
+			}
+			// Copies the chunks of the degrees of edge if another graph shares them, so that
+			// added(edge) and removed(edge) can't fail afterwards.
+			auto own_degrees(edge_struct<E> const& edge) -> void {
+				out_degrees.mutable_at(static_cast<std::size_t>(edge.src));
+				in_degrees.mutable_at(static_cast<std::size_t>(edge.dst));
+			}
+			// Copies the chunk of the value of id if another graph shares it, so that release(id)
+			// can't fail afterwards.
+			auto own_value(node_id id) -> void {
+				values.mutable_at(static_cast<std::size_t>(id));
+			}
+			// The room to recycle every id is made when ids are created, so that erasing a node cannot
+			// fail once the edges of its node are gone.
+			auto reserve_free_ids() -> void {
+				if (free_ids.capacity() < values.capacity()) {
+					free_ids.reserve(values.capacity());
+				}
+			}
+			// Frees id, whose value was owned with own_value. A value that can't be reset without
+			// the risk of throwing stays until the id is reused.
+			auto release(node_id id) noexcept -> void {
+				fingerprint -= hash(id);
+				if constexpr (std::is_nothrow_default_constructible_v<N>
+				              and std::is_nothrow_move_assignable_v<N>)
+				{
+					values.mutable_at(static_cast<std::size_t>(id)) = N{};
+				}
+				free_ids.push_back(id);
+			}
+		};
+		static constexpr bool hashed = detail::hashable<N> and detail::hashable<E>;
+		// Chunked sets copy the chunks they share and merge the ones left small when they erase.
+		static constexpr bool erase_allocates = Storage::local_writes and !Storage::node_based;
+		using storage_ptr = std::shared_ptr<storage const>;
+		std::pmr::memory_resource* resource_ = std::pmr::get_default_resource();
+		storage_ptr storage_{}; // null for an empty graph
+
+		// The block and its reference count are one allocation from the resource.
+		template<typename... Args>
+		[[nodiscard]] auto make_storage(Args const&... args) const -> storage_ptr {
+			auto alloc = std::pmr::polymorphic_allocator<storage>(resource_);
+			return std::allocate_shared<storage>(alloc, args..., resource_);
+		}
+		[[nodiscard]] auto get_data() const noexcept -> storage const& {
+			static auto const empty_storage = storage(std::pmr::get_default_resource());
+			return storage_ ? *storage_ : empty_storage;
+		}
+		// Returns the storage to modify, copying it first if another graph shares it.
+		auto mutable_data() -> storage& {
+			if (!storage_) {
+				storage_ = make_storage();
+			}
+			else if (storage_.use_count() > 1) {
+				storage_ = make_storage(*storage_); // shares what the storage policy can share
+			}
+			else {
+				// the last graph to share the block may have let go of it in another thread; its
+				// reads of the block happen before the writes that follow (ThreadSanitizer does not
+				// model the fence and reports them as races)
+				std::atomic_thread_fence(std::memory_order_acquire);
+			}
+			// only this graph can reach the block now, it was never const itself
+			return const_cast<storage&>(*storage_);
+		}
+		// Like mutable_data, and moves the given iterators into the copy when it copies: the ids of
+		// an edge are the same in both, so its position is found without comparing a node value.
+		template<typename... Iterators>
+		auto mutable_data(Iterators&... iters) -> storage& {
+			auto const* const before = storage_.get();
+			// the iterators point into a shared block, which the other graphs may free or write to
+			// once this one has let go of it
+			auto const keep = storage_.use_count() > 1 ? storage_ : storage_ptr{};
+			auto& data = mutable_data();
+			if (&data != before) {
+				((iters = make_iterator(iters.iter_ == iters.end_ ? data.all_edges.end()
+				                                                 : data.all_edges.find(*iters.iter_))),
+				 ...);
+			}
+			return data;
+		}
+		[[nodiscard]] auto
+		make_iterator(typename edges_set<Storage, N, E>::const_iterator iter) const noexcept
+		   -> iterator {
+			auto const& data = get_data();
+			return iterator(&data.values, data.all_edges.begin(), data.all_edges.end(), iter);
+		}
+		// Inserts a batch of edges into both edge sets, skipping those already there, and returns how
+		// many were new. If an insertion throws, the edges inserted until then are taken out again,
+		// and the degrees and fingerprint are only counted once nothing can throw.
+		auto insert_new_edges(std::vector<edge_struct<E>>& batch) -> std::size_t {
+			auto& data = mutable_data();
+			auto const comp = data.all_edges.key_comp();
+			std::sort(batch.begin(), batch.end(), comp);
+			auto const equivalent = [&comp](auto const& lhs, auto const& rhs) {
+				return !comp(lhs, rhs);
+			};
+			batch.erase(std::unique(batch.begin(), batch.end(), equivalent), batch.end());
+			for (auto const& i : batch) {
+				data.own_degrees(i);
+			}
+			auto inserted = std::vector<edge_struct<E>>{};
+			inserted.reserve(batch.size());
+			change_sets(
+			   [&batch, &inserted](auto& out_set, auto& in_set) {
+				   try {
+					   if constexpr (Storage::local_writes) {
+						   auto hint = out_set.cbegin();
+						   for (auto const& i : batch) {
+							   if (insert_sorted(out_set, hint, i)) {
+								   inserted.push_back(i);
+							   }
+						   }
+						   std::sort(inserted.begin(), inserted.end(), in_set.key_comp());
+						   auto in_hint = in_set.cbegin();
+						   for (auto const& i : inserted) {
+							   insert_sorted(in_set, in_hint, i);
+						   }
+					   }
+					   else {
+						   // one merge per vector instead of moving its tail once per edge
+						   for (auto const& i : batch) {
+							   if (out_set.find(i) == out_set.end()) {
+								   inserted.push_back(i);
+							   }
+						   }
+						   out_set.insert(inserted.begin(), inserted.end());
+						   in_set.insert(inserted.begin(), inserted.end());
+					   }
+				   } catch (...) {
+					   if constexpr (!erase_allocates) { // copies are dropped instead
+						   for (auto const& i : inserted) { // erasing a missing key is a no-op
+							   in_set.erase(i);
+							   out_set.erase(i);
+						   }
+					   }
+					   throw;
+				   }
+			   },
+			   data.all_edges,
+			   data.in_edges);
+			for (auto const& i : inserted) {
+				data.added(i);
+			}
+			return inserted.size();
+		}
+		// Inserts value into set unless it is already there. hint is where the previous value of a
+		// sorted batch went, so the next value usually belongs right there and costs no search.
+		template<typename Set>
+		static auto insert_sorted(Set& set,
+		                          typename Set::const_iterator& hint,
+		                          typename Set::value_type const& value) -> bool {
+			auto const& comp = set.key_comp();
+			if ((hint != set.begin() and !comp(*std::prev(hint), value))
+			    or (hint != set.end() and !comp(value, *hint)))
+			{
+				hint = set.lower_bound(value); // value is not between the neighbours of hint
+				if (hint != set.end() and !comp(value, *hint)) {
+					++hint;
+					return false;
+				}
+			}
+			hint = std::next(set.emplace_hint(hint, value));
+			return true;
+		}
 		auto inner_insert_edge(N const& src, N const& dst, E const& weight) -> bool {
-			if (find(src, dst, weight) != end()) { // check edge inside
+			auto& data = mutable_data();
+			auto const key = std::tie(src, dst, weight);
+			auto hint = data.all_edges.lower_bound(key); // check edge inside
+			if (hint != data.all_edges.end() and !data.all_edges.key_comp()(key, *hint)) {
 				return false;
 			}
-			auto node_src = *(all_nodes_.find(src));
-			auto node_dst = *(all_nodes_.find(dst));
-			auto edge = std::make_shared<E>(weight);
-			static_assert(std::is_same_v<decltype(edge), std::shared_ptr<E>>);
-			edge_struct<N, E> value{node_src, node_dst, edge};
-			all_edges_.emplace(value);
+			auto const value =
+			   edge_struct<E>{*(data.all_nodes.find(src)), *(data.all_nodes.find(dst)), weight};
+			data.added(value); // counted first, as counting may copy shared chunks of the degrees
+			try {
+				data.all_edges.emplace_hint(hint, value);
+				data.in_edges.insert(value);
+			} catch (...) {
+				data.all_edges.erase(value); // erasing a missing key is a no-op
+				data.removed(value);
+				throw;
+			}
 			return true;
 		}
-		[[nodiscard]] auto binary_search(N const& value) const noexcept
-		   -> decltype(all_edges_.begin()) {
-			auto end = --all_edges_.end();
-			auto start = all_edges_.begin();
-			if (*(start->src) == value or *(end->src) == value) {
-				return *(start->src) == value ? start : end;
+		// The part of the fingerprint that hashes the value of node id: its own hash and the hashes
+		// of its edges, which are node handles or edge_structs.
+		template<typename Edges>
+		[[nodiscard]] static auto rehash(storage const& data, node_id id, Edges const& edges) noexcept
+		   -> std::uint64_t {
+			auto sum = data.hash(id);
+			for (auto const& i : edges) {
+				if constexpr (std::same_as<typename Edges::value_type, edge_struct<E>>) {
+					sum += data.hash(i);
+				}
+				else {
+					sum += data.hash(i.value());
+				}
+			}
+			return sum;
+		} // O(d)
+		// Builds an empty graph out of a list of edges, and of the nodes in nodes, which may or may
+		// not have edges too. Nodes and edges are sorted and deduplicated once, and each set is then
+		// filled in order, which costs amortised O(1) per element instead of a lookup per insertion.
+		// Runs the sorts, transforms and deduplications through run, serially unless build_graph in
+		// parallel_graph.hpp passes algorithms that run under an execution policy. Throws
+		// std::length_error, naming caller, if there are 2^32 nodes or more.
+		template<typename Algorithms = detail::serial_algorithms>
+		auto bulk_load(char const* caller,
+		               std::vector<value_type> const& edges,
+		               std::vector<N> const& nodes = {},
+		               Algorithms const& run = {}) -> void {
+			if (edges.empty() and nodes.empty()) {
+				return;
+			}
+			auto& data = mutable_data();
+			// a temporary, from the heap rather than from a resource that may never give it back
+			auto values = std::vector<N>(2 * edges.size() + nodes.size());
+			auto const tos = values.begin() + static_cast<std::ptrdiff_t>(edges.size());
+			auto const from = [](value_type const& i) { return i.from; };
+			auto const to = [](value_type const& i) { return i.to; };
+			run.transform(edges.begin(), edges.end(), values.begin(), from);
+			run.transform(edges.begin(), edges.end(), tos, to);
+			std::copy(nodes.begin(), nodes.end(), tos + static_cast<std::ptrdiff_t>(edges.size()));
+			run.sort(values.begin(), values.end());
+			values.erase(run.unique(values.begin(), values.end()), values.end());
+			if (values.size() > std::numeric_limits<std::uint32_t>::max()) {
+				throw std::length_error(std::string("Cannot call ") + caller
+				                        + " with 2^32 nodes or more");
 			}
-			auto mid = decltype(all_edges_.begin()){};
-			while (*(start->src) < value and *(end->src) > value) {
-				mid = start;
-				std::advance(mid, std::distance(start, end) / 2);
-				if (*(mid->src) < value) {
-					start = mid;
-					continue;
+			auto const id_of = [&values](N const& value) {
+				auto const iter = std::lower_bound(values.begin(), values.end(), value);
+				return static_cast<node_id>(iter - values.begin());
+			};
+			auto structs = std::vector<edge_struct<E>>(edges.size());
+			auto const intern = [&id_of](value_type const& i) {
+				return edge_struct<E>{id_of(i.from), id_of(i.to), i.weight};
+			};
+			run.transform(edges.begin(), edges.end(), structs.begin(), intern);
+			// the values are only read through the node table from here on
+			for (auto& i : values) {
+				data.values.push_back(std::move(i));
+			}
+			data.reserve_free_ids();
+			data.reserve_degrees(values.size());
+			for (auto i = std::size_t{0}; i < values.size(); ++i) {
+				data.all_nodes.insert(data.all_nodes.end(), static_cast<node_id>(i));
+				data.fingerprint += data.hash(static_cast<node_id>(i));
+			}
+			// ids were handed out in value order, so comparing ids is comparing the values here
+			auto const by_src = [](auto const& lhs, auto const& rhs) {
+				return std::tie(lhs.src, lhs.dst, lhs.edge) < std::tie(rhs.src, rhs.dst, rhs.edge);
+			};
+			run.sort(structs.begin(), structs.end(), by_src);
+			auto const same = [](auto const& lhs, auto const& rhs) {
+				return lhs.src == rhs.src and lhs.dst == rhs.dst and lhs.edge == rhs.edge;
+			};
+			auto const last = run.unique(structs.begin(), structs.end(), same);
+			structs.erase(last, structs.end());
+			// the edges of each src are one run of structs now, appended in order
+			for (auto const& i : structs) {
+				data.all_edges.insert(data.all_edges.end(), i);
+				data.added(i);
+			}
+			auto const by_dst = [](auto const& lhs, auto const& rhs) {
+				return std::tie(lhs.dst, lhs.src, lhs.edge) < std::tie(rhs.dst, rhs.src, rhs.edge);
+			};
+			run.sort(structs.begin(), structs.end(), by_dst);
+			for (auto const& i : structs) {
+				data.in_edges.insert(data.in_edges.end(), i);
+			}
+		} // O((e + k) log(e + k)), k is the size of nodes
+		// Takes the nodes victims out of the graph with every edge of them, and returns the edges.
+		// With sweep, one pass over the edges finds them instead of a search per victim. The sets
+		// change all or nothing, and the degrees, fingerprint and values are owned beforehand, so
+		// running out of memory leaves the graph as it was.
+		auto remove_nodes(std::vector<node_id> const& victims, bool sweep)
+		   -> std::vector<edge_struct<E>> {
+			auto& data = mutable_data(); // a copy keeps the ids of victims
+			auto edges = std::vector<edge_struct<E>>{};
+			auto dead = std::vector<bool>{};
+			if (sweep) {
+				dead.resize(data.values.size());
+				for (auto const id : victims) {
+					dead[static_cast<std::size_t>(id)] = true;
 				}
-				if (*(mid->src) > value) {
-					end = mid;
-					continue;
+			}
+			auto const is_dead = [&dead](edge_struct<E> const& edge) {
+				return dead[static_cast<std::size_t>(edge.src)]
+				       or dead[static_cast<std::size_t>(edge.dst)];
+			};
+			if (sweep) {
+				std::copy_if(data.all_edges.begin(),
+				             data.all_edges.end(),
+				             std::back_inserter(edges),
+				             is_dead);
+			}
+			else {
+				for (auto const id : victims) {
+					auto const [out_first, out_last] = data.all_edges.equal_range(id);
+					edges.insert(edges.end(), out_first, out_last);
+					auto const [in_first, in_last] = data.in_edges.equal_range(id);
+					edges.insert(edges.end(), in_first, in_last);
 				}
-				return mid;
+				// an edge between two victims, or a reflexive one, was found twice
+				auto const comp = data.all_edges.key_comp();
+				std::sort(edges.begin(), edges.end(), comp);
+				auto const equivalent = [&comp](auto const& lhs, auto const& rhs) {
+					return !comp(lhs, rhs);
+				};
+				edges.erase(std::unique(edges.begin(), edges.end(), equivalent), edges.end());
+			}
+			for (auto const& edge : edges) {
+				data.own_degrees(edge);
+			}
+			for (auto const id : victims) {
+				data.own_value(id);
+			}
+			change_sets(
+			   [&](auto& node_set, auto& out_set, auto& in_set) {
+				   if (sweep) {
+					   erase_if(out_set, is_dead);
+					   erase_if(in_set, is_dead);
+				   }
+				   else {
+					   for (auto const& edge : edges) {
+						   out_set.erase(edge);
+						   in_set.erase(edge);
+					   }
+				   }
+				   for (auto const id : victims) {
+					   node_set.erase(id);
+				   }
+			   },
+			   data.all_nodes,
+			   data.all_edges,
+			   data.in_edges);
+			for (auto const& edge : edges) {
+				data.removed(edge);
+			}
+			for (auto const id : victims) {
+				data.release(id);
+			}
+			return edges;
+		} // O(k log(n) + d log(e)), d is the total degree of the victims, O(n + e) with sweep
+		// Calls change on sets, all or nothing. Chunked sets allocate to erase as well as to insert,
+		// so change gets copies of them that share their chunks, and the sets take the copies only
+		// once change returns. Other sets are changed in place, where erasing cannot fail.
+		template<typename F, typename... Sets>
+		auto change_sets(F change, Sets&... sets) const -> void {
+			if constexpr (erase_allocates) {
+				auto copies = std::tuple{storage::copy_set(sets, sets.key_comp(), resource_)...};
+				std::apply(change, copies);
+				std::apply([&sets...](auto&... copy) { (sets.swap(copy), ...); }, copies);
+			}
+			else {
+				change(sets...);
 			}
-			return all_edges_.end();
+		}
+		[[nodiscard]] auto distinct_dsts(N const& src) const
+		   -> ranges::subrange<connection_iterator> {
+			auto const& data = get_data();
+			auto [first, last] = data.all_edges.equal_range(std::tie(src)); // every edge out of src
+			return {connection_iterator(&data.values, first, last),
+			        connection_iterator(&data.values, last, last)};
 		}
 	};
+
+	namespace detail {
+		// What the algorithms on graphs see of one: its nodes as ids, which are dense indices below
+		// id_count(g) with a few unused ones left behind by erased nodes, and the edges straight from
+		// the edge sets. Ids and edges stay valid until the graph is next modified. An unused id
+		// holds N{} and would find the edges of the node N{}, so only the ids of nodes are asked
+		// about.
+		struct graph_access {
+			template<typename G>
+			[[nodiscard]] static auto id_count(G const& g) noexcept -> std::size_t {
+				return g.get_data().values.size();
+			}
+			// The unused ids below id_count(g).
+			template<typename G>
+			[[nodiscard]] static auto free_ids(G const& g) noexcept -> auto const& {
+				return g.get_data().free_ids;
+			}
+			// Every node id, in the order of the node values.
+			template<typename G>
+			[[nodiscard]] static auto nodes(G const& g) noexcept -> auto const& {
+				return g.get_data().all_nodes;
+			}
+			// Returns id_count(g) if value is not a node.
+			template<typename G, typename N>
+			[[nodiscard]] static auto id(G const& g, N const& value) -> std::size_t {
+				auto const& data = g.get_data();
+				auto const iter = data.all_nodes.find(value);
+				return iter == data.all_nodes.end() ? data.values.size()
+				                                    : static_cast<std::size_t>(*iter);
+			} // O(log(n))
+			template<typename G>
+			[[nodiscard]] static auto value(G const& g, node_id id) noexcept -> auto const& {
+				return g.get_data().value(id);
+			}
+			// Every edge, as edge_structs in (src, dst, weight) order.
+			template<typename G>
+			[[nodiscard]] static auto edges(G const& g) noexcept -> auto const& {
+				return g.get_data().all_edges;
+			}
+			// The outgoing edges of a node, in (dst, weight) order.
+			template<typename G>
+			[[nodiscard]] static auto out_edges(G const& g, node_id id) {
+				auto const [first, last] = g.get_data().all_edges.equal_range(id);
+				return ranges::subrange(first, last);
+			} // O(log(e))
+			// Builds the empty graph g out of a list of edges and a list of nodes, running the sorts
+			// of the bulk load through run, which has the members of serial_algorithms.
+			// caller names the function that builds it, for the error if there are too many nodes.
+			template<typename G,
+			         typename Edges,
+			         typename Nodes,
+			         typename Algorithms = serial_algorithms>
+			static auto bulk_load(G& g,
+			                      char const* caller,
+			                      Edges const& edges,
+			                      Nodes const& nodes,
+			                      Algorithms const& run = {}) -> void {
+				g.bulk_load(caller, edges, nodes, run);
+			} // O((e + k) log(e + k)), k is the size of nodes
+			// The incoming edges of a node, in (src, weight) order.
+			template<typename G>
+			[[nodiscard]] static auto in_edges(G const& g, node_id id) {
+				auto const [first, last] = g.get_data().in_edges.equal_range(id);
+				return ranges::subrange(first, last);
+			} // O(log(e))
+		};
+	} // namespace detail
 } // namespace gdwg
 
+// Hashes a graph by its fingerprint, in O(1).
+template<typename N, typename E, typename Storage>
+requires gdwg::detail::hashable<N> and gdwg::detail::hashable<E>
+struct std::hash<gdwg::graph<N, E, Storage>> {
+	auto operator()(gdwg::graph<N, E, Storage> const& g) const noexcept -> std::size_t {
+		return g.fingerprint();
+	}
+};
+
 #endif // GDWG_GRAPH_HPP
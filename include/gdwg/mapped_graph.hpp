@@ -0,0 +1,656 @@
+#ifndef GDWG_MAPPED_GRAPH_HPP
+#define GDWG_MAPPED_GRAPH_HPP
+
+#include <algorithm>
+#include <array>
+#include <concepts/concepts.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <istream>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <memory_resource>
+#include <ostream>
+#include <range/v3/utility/common_tuple.hpp>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "gdwg/graph.hpp"
+
+// A graph file, version 1, holds a graph in the layout of a csr_graph, section after section:
+//   header    a detail::file_header, which gives the counts below
+//   nodes     N[node_count], sorted, a node is identified by its position here
+//   offsets   std::uint64_t[node_count + 1], the edges of nodes[i] are [offsets[i], offsets[i + 1])
+//   dsts      std::uint32_t[edge_count], the positions of the destination nodes in nodes
+//   weights   E[edge_count], the edges of a node sorted by dst and then weight, none twice
+//   checksum  std::uint64_t, of every byte before it
+// Every section starts at a multiple of 64 bytes, padded with zeros, so that once the file is
+// mapped each of them is an aligned array that can be read where it lies. Nodes, weights and
+// integers are stored as their bytes, in the byte order of the machine that wrote the file.
+namespace gdwg {
+	namespace detail {
+		inline constexpr auto file_magic = std::array<char, 8>{'g', 'd', 'w', 'g', 'b', 'i', 'n', 0};
+		inline constexpr auto file_version = std::uint32_t{1};
+		inline constexpr auto file_byte_order = std::uint32_t{0x01020304};
+		inline constexpr auto section_alignment = std::size_t{64};
+	} // namespace detail
+
+	// Values that a graph file holds as their bytes. Their bytes must mean the same thing in the
+	// process that reads the file, which rules out pointers and handles even though they qualify.
+	template<typename T>
+	concept binary_value =
+	   std::is_trivially_copyable_v<T> and alignof(T) <= detail::section_alignment;
+
+	namespace detail {
+		struct file_header {
+			std::array<char, 8> magic;
+			std::uint32_t version;
+			std::uint32_t byte_order;
+			std::uint32_t node_size;
+			std::uint32_t node_alignment;
+			std::uint32_t edge_size;
+			std::uint32_t edge_alignment;
+			std::uint64_t node_count;
+			std::uint64_t edge_count;
+		};
+		static_assert(std::is_trivially_copyable_v<file_header> and sizeof(file_header) == 48);
+
+		template<typename N, typename E>
+		[[nodiscard]] auto make_header(std::size_t node_count, std::size_t edge_count) noexcept
+		   -> file_header {
+			return {file_magic,
+			        file_version,
+			        file_byte_order,
+			        sizeof(N),
+			        alignof(N),
+			        sizeof(E),
+			        alignof(E),
+			        node_count,
+			        edge_count};
+		}
+
+		[[nodiscard]] constexpr auto align_up(std::size_t size, std::size_t alignment) noexcept
+		   -> std::size_t {
+			return (size + alignment - 1) / alignment * alignment;
+		}
+
+		// Where each section of a file starts, and how long the file is.
+		struct file_layout {
+			std::size_t nodes;
+			std::size_t offsets;
+			std::size_t dsts;
+			std::size_t weights;
+			std::size_t checksum;
+			std::size_t size;
+		};
+		template<typename N, typename E>
+		[[nodiscard]] constexpr auto
+		make_layout(std::size_t node_count, std::size_t edge_count) noexcept -> file_layout {
+			auto layout = file_layout{};
+			layout.nodes = align_up(sizeof(file_header), section_alignment);
+			layout.offsets = align_up(layout.nodes + node_count * sizeof(N), section_alignment);
+			auto const offsets_end = layout.offsets + (node_count + 1) * sizeof(std::uint64_t);
+			layout.dsts = align_up(offsets_end, section_alignment);
+			auto const dsts_end = layout.dsts + edge_count * sizeof(std::uint32_t);
+			layout.weights = align_up(dsts_end, section_alignment);
+			layout.checksum = align_up(layout.weights + edge_count * sizeof(E), sizeof(std::uint64_t));
+			layout.size = layout.checksum + sizeof(std::uint64_t);
+			return layout;
+		}
+
+		[[noreturn]] inline auto file_error(char const* caller, char const* reason) -> void {
+			throw std::runtime_error(std::string("Cannot call ") + caller + " if " + reason);
+		}
+
+		// Checks that a file with this header was written by write_binary<N, E>, on a machine like
+		// this one, and that the counts it gives describe a file that fits in memory.
+		template<typename N, typename E>
+		auto check_header(file_header const& header, char const* caller) -> void {
+			if (header.magic != file_magic) {
+				file_error(caller, "the file is not a graph file");
+			}
+			if (header.version != file_version) {
+				file_error(caller, "the file has an unsupported version");
+			}
+			if (header.byte_order != file_byte_order) {
+				file_error(caller, "the file was written with another byte order");
+			}
+			if (header.node_size != sizeof(N) or header.node_alignment != alignof(N)
+			    or header.edge_size != sizeof(E) or header.edge_alignment != alignof(E))
+			{
+				file_error(caller, "the file holds other node or weight types");
+			}
+			// so that make_layout cannot overflow
+			constexpr auto max_count = std::numeric_limits<std::size_t>::max() / 2
+			                           / (sizeof(N) + sizeof(E) + 2 * sizeof(std::uint64_t));
+			if (header.node_count > std::numeric_limits<std::uint32_t>::max()
+			    or header.edge_count > max_count)
+			{
+				file_error(caller, "the file is corrupt");
+			}
+		}
+
+		// Checks that the sections of a file agree with each other, so that walking its edges stays
+		// within them, and that the edges out of each node are sorted by dst and then weight, as
+		// the searches of mapped_graph expect. The checksum can't vouch for that: anyone can compute
+		// it for any bytes.
+		template<typename N, typename E>
+		auto check_sections(std::span<N const> nodes,
+		                    std::span<std::uint64_t const> offsets,
+		                    std::span<std::uint32_t const> dsts,
+		                    std::span<E const> weights,
+		                    char const* caller) -> void {
+			auto const not_increasing = [](N const& lhs, N const& rhs) { return !(lhs < rhs); };
+			auto const outside = [n = nodes.size()](std::uint32_t dst) { return dst >= n; };
+			if (offsets.front() != 0 or offsets.back() != dsts.size() or weights.size() != dsts.size()
+			    or !std::is_sorted(offsets.begin(), offsets.end())
+			    or std::adjacent_find(nodes.begin(), nodes.end(), not_increasing) != nodes.end()
+			    or std::any_of(dsts.begin(), dsts.end(), outside))
+			{
+				file_error(caller, "the file is corrupt");
+			}
+			for (auto src = std::size_t{0}; src + 1 < offsets.size(); ++src) {
+				for (auto i = offsets[src] + 1; i < offsets[src + 1]; ++i) {
+					// an edge is never written twice, so each one comes strictly after the one before
+					if (dsts[i] < dsts[i - 1]
+					    or (dsts[i] == dsts[i - 1] and !(weights[i - 1] < weights[i])))
+					{
+						file_error(caller, "the file is corrupt");
+					}
+				}
+			}
+		} // O(n + e)
+
+		// A 64-bit hash of a stream of bytes, which can be fed in pieces of any size.
+		class checksum {
+		public:
+			auto update(std::byte const* data, std::size_t size) noexcept -> void {
+				length_ += size;
+				for (; size > 0 and filled_ > 0; ++data, --size) {
+					put(*data);
+				}
+				for (; size >= sizeof(std::uint64_t); data += sizeof(std::uint64_t)) {
+					auto word = std::uint64_t{};
+					std::memcpy(&word, data, sizeof(word));
+					mix(word);
+					size -= sizeof(std::uint64_t);
+				}
+				for (; size > 0; ++data, --size) {
+					put(*data);
+				}
+			}
+			[[nodiscard]] auto value() const noexcept -> std::uint64_t {
+				auto result = *this;
+				if (filled_ > 0) {
+					std::fill(result.tail_.begin() + filled_, result.tail_.end(), std::byte{0});
+					result.put_tail();
+				}
+				result.mix(length_);
+				return result.hash_;
+			}
+
+		private:
+			std::uint64_t hash_ = 0x6a09e667f3bcc908;
+			std::uint64_t length_ = 0;
+			std::array<std::byte, sizeof(std::uint64_t)> tail_{};
+			std::ptrdiff_t filled_ = 0;
+
+			auto mix(std::uint64_t word) noexcept -> void {
+				hash_ = (hash_ ^ word) * 0x9e3779b97f4a7c15;
+				hash_ ^= hash_ >> 29;
+			}
+			auto put(std::byte byte) noexcept -> void {
+				tail_[static_cast<std::size_t>(filled_++)] = byte;
+				if (filled_ == std::ssize(tail_)) {
+					put_tail();
+				}
+			}
+			auto put_tail() noexcept -> void {
+				auto word = std::uint64_t{};
+				std::memcpy(&word, tail_.data(), sizeof(word));
+				mix(word);
+				filled_ = 0;
+			}
+		};
+
+		// Writes the bytes of values to a stream through a buffer, checksumming them on the way.
+		class file_writer {
+		public:
+			explicit file_writer(std::ostream& os)
+			: os_{&os} {}
+			template<typename T>
+			auto put(T const& value) -> void {
+				if (size_ + sizeof(T) > buffer_.size()) {
+					flush();
+				}
+				std::memcpy(buffer_.data() + size_, std::addressof(value), sizeof(T));
+				size_ += sizeof(T);
+				written_ += sizeof(T);
+			}
+			// Writes zeros up to the next multiple of alignment.
+			auto pad(std::size_t alignment) -> void {
+				while (written_ % alignment != 0) {
+					put(std::byte{0});
+				}
+			}
+			auto flush() -> void {
+				sum_.update(buffer_.data(), size_);
+				os_->write(reinterpret_cast<char const*>(buffer_.data()),
+				           static_cast<std::streamsize>(size_));
+				size_ = 0;
+				if (!*os_) {
+					file_error("gdwg::write_binary", "the stream can't be written");
+				}
+			}
+			// The checksum of everything put so far.
+			[[nodiscard]] auto checksum() -> std::uint64_t {
+				flush();
+				return sum_.value();
+			}
+
+		private:
+			std::ostream* os_;
+			std::vector<std::byte> buffer_ = std::vector<std::byte>(std::size_t{1} << 16);
+			std::size_t size_ = 0;
+			std::size_t written_ = 0;
+			detail::checksum sum_{};
+		};
+
+		// Reads arrays of values from a stream, checksumming them on the way.
+		class file_reader {
+		public:
+			file_reader(std::istream& is, char const* caller)
+			: is_{&is}
+			, caller_{caller} {}
+			template<typename T>
+			auto get(T* first, std::size_t count) -> void {
+				auto const size = count * sizeof(T);
+				is_->read(reinterpret_cast<char*>(first), static_cast<std::streamsize>(size));
+				if (static_cast<std::size_t>(is_->gcount()) != size) {
+					file_error(caller_, "the file is truncated");
+				}
+				sum_.update(reinterpret_cast<std::byte const*>(first), size);
+				read_ += size;
+			}
+			// Reads count values into vec a piece at a time, so that a count too large for the file
+			// fails as truncated once the file runs out, not by allocating all of it first.
+			template<typename T>
+			auto get(std::vector<T>& vec, std::size_t count) -> void {
+				constexpr auto piece = std::max(std::size_t{1}, (std::size_t{1} << 16) / sizeof(T));
+				vec.clear();
+				while (vec.size() < count) {
+					auto const size = vec.size();
+					vec.resize(size + std::min(piece, count - size));
+					get(vec.data() + size, vec.size() - size);
+				}
+			}
+			// Reads the padding up to position.
+			auto skip_to(std::size_t position) -> void {
+				auto padding = std::array<std::byte, section_alignment>{};
+				get(padding.data(), position - read_);
+			}
+			[[nodiscard]] auto checksum() const noexcept -> std::uint64_t {
+				return sum_.value();
+			}
+
+		private:
+			std::istream* is_;
+			char const* caller_;
+			std::size_t read_ = 0;
+			detail::checksum sum_{};
+		};
+
+		// A read-only mapping of a whole file, which is unmapped when the mapping is destroyed.
+		class file_mapping {
+		public:
+			file_mapping(std::filesystem::path const& path, char const* caller) {
+				auto const fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+				if (fd == -1) {
+					file_error(caller, "the file can't be opened");
+				}
+				struct stat info {};
+				auto mapped = ::fstat(fd, &info) == 0;
+				size_ = mapped ? static_cast<std::size_t>(info.st_size) : 0;
+				if (mapped and size_ > 0) {
+					auto* const address = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+					mapped = address != MAP_FAILED;
+					data_ = mapped ? static_cast<std::byte const*>(address) : nullptr;
+				}
+				::close(fd); // the mapping keeps the file open
+				if (!mapped) {
+					file_error(caller, "the file can't be mapped");
+				}
+			}
+			file_mapping(file_mapping&& other) noexcept
+			: data_{std::exchange(other.data_, nullptr)}
+			, size_{std::exchange(other.size_, 0)} {}
+			auto operator=(file_mapping&& other) noexcept -> file_mapping& {
+				std::swap(data_, other.data_);
+				std::swap(size_, other.size_);
+				return *this;
+			}
+			~file_mapping() {
+				if (data_ != nullptr) {
+					::munmap(const_cast<std::byte*>(data_), size_);
+				}
+			}
+
+			[[nodiscard]] auto data() const noexcept -> std::byte const* {
+				return data_;
+			}
+			[[nodiscard]] auto size() const noexcept -> std::size_t {
+				return size_;
+			}
+
+		private:
+			std::byte const* data_ = nullptr;
+			std::size_t size_ = 0;
+		};
+	} // namespace detail
+
+	// Writes g to os as a graph file, in one pass over its nodes and three over its edges, through
+	// a fixed buffer: nothing the size of the graph is built, except one position per node id.
+	template<typename N, typename E, typename Storage>
+	requires binary_value<N> and binary_value<E>
+	auto write_binary(std::ostream& os, graph<N, E, Storage> const& g) -> void {
+		using access = detail::graph_access;
+		auto const& nodes = access::nodes(g);
+		auto const& edges = access::edges(g);
+		auto out = detail::file_writer(os);
+		out.put(detail::make_header<N, E>(nodes.size(), edges.size()));
+		out.pad(detail::section_alignment);
+		// a node is written out as its position in value order, which its id doesn't follow
+		auto positions = std::vector<std::uint32_t>(access::id_count(g));
+		auto position = std::uint32_t{0};
+		for (auto const id : nodes) {
+			positions[static_cast<std::size_t>(id)] = position++;
+			out.put(access::value(g, id));
+		}
+		out.pad(detail::section_alignment);
+		// the edges are in (src, dst, weight) order, so the edges of each node are one run of them
+		auto offset = std::uint64_t{0};
+		out.put(offset);
+		auto edge = edges.begin();
+		for (auto const id : nodes) {
+			for (; edge != edges.end() and edge->src == id; ++edge) {
+				++offset;
+			}
+			out.put(offset);
+		}
+		out.pad(detail::section_alignment);
+		for (auto const& i : edges) {
+			out.put(positions[static_cast<std::size_t>(i.dst)]);
+		}
+		out.pad(detail::section_alignment);
+		for (auto const& i : edges) {
+			out.put(i.edge);
+		}
+		out.pad(sizeof(std::uint64_t));
+		out.put(out.checksum());
+		out.flush();
+	} // O(n + e)
+
+	// Reads a graph file written by write_binary<N, E> from is, and checks its checksum and that its
+	// sections agree before building anything. The edges come out sorted, so the graph is
+	// bulk-loaded from them.
+	template<typename N, typename E, typename Storage = tree_storage>
+	requires binary_value<N> and binary_value<E>
+	auto read_binary(std::istream& is,
+	                 std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+	   -> graph<N, E, Storage> {
+		constexpr auto caller = "gdwg::read_binary";
+		auto in = detail::file_reader(is, caller);
+		auto header = detail::file_header{};
+		in.get(&header, 1);
+		detail::check_header<N, E>(header, caller);
+		auto const n = static_cast<std::size_t>(header.node_count);
+		auto const e = static_cast<std::size_t>(header.edge_count);
+		auto const layout = detail::make_layout<N, E>(n, e);
+		// the counts are not checked yet, the sections only grow as far as the file goes
+		auto nodes = std::vector<N>{};
+		auto offsets = std::vector<std::uint64_t>{};
+		auto dsts = std::vector<std::uint32_t>{};
+		auto weights = std::vector<E>{};
+		in.skip_to(layout.nodes);
+		in.get(nodes, n);
+		in.skip_to(layout.offsets);
+		in.get(offsets, n + 1);
+		in.skip_to(layout.dsts);
+		in.get(dsts, e);
+		in.skip_to(layout.weights);
+		in.get(weights, e);
+		in.skip_to(layout.checksum);
+		auto const expected = in.checksum();
+		auto stored = std::uint64_t{};
+		in.get(&stored, 1);
+		if (stored != expected) {
+			detail::file_error(caller, "the checksum doesn't match");
+		}
+		detail::check_sections<N, E>(nodes, offsets, dsts, weights, caller);
+
+		using value_type = typename graph<N, E, Storage>::value_type;
+		auto edges = std::vector<value_type>{};
+		edges.reserve(e);
+		for (auto src = std::size_t{0}; src < n; ++src) {
+			for (auto i = offsets[src]; i < offsets[src + 1]; ++i) {
+				edges.push_back({nodes[src], nodes[dsts[i]], weights[i]});
+			}
+		}
+		// every node goes in with the edges, the bulk load drops the ones the edges also add
+		auto g = graph<N, E, Storage>(resource);
+		detail::graph_access::bulk_load(g, caller, edges, nodes);
+		return g;
+	} // O(n log(n) + e log(e))
+
+	// How much of a file mapped_graph checks before serving queries from it. full reads the whole
+	// file once, to check its checksum and that its sections agree with each other. header_only
+	// checks the header and the size of the file, which takes the same time whatever the size of
+	// the graph, and trusts the rest of it: it is only for files that come from a trusted writer
+	// and can't have been damaged since, as queries on a file that is corrupt or was crafted to
+	// look valid read outside of it.
+	enum class file_check { full, header_only };
+
+	// A graph file mapped into memory and queried where it lies, with the interface of a csr_graph:
+	// opening one reads nothing but the header, and the checksum unless that is skipped, and the
+	// pages of the file are then read in as queries touch them. Several processes mapping the same
+	// file share its pages.
+	// A mapped_graph is never modified, and any number of threads can read one at the same time
+	// without locking. The file must not be modified while it is mapped.
+	template<concepts::regular N, concepts::regular E>
+	requires concepts::totally_ordered<N>and concepts::totally_ordered<E>and binary_value<N>and
+	   binary_value<E> class mapped_graph {
+	public:
+		class iterator {
+		public:
+			using value_type = ranges::common_tuple<N, N, E>;
+			using difference_type = std::ptrdiff_t;
+			using iterator_category = std::bidirectional_iterator_tag;
+			iterator() = default;
+
+			explicit iterator(mapped_graph const* g, std::size_t src, std::size_t edge) noexcept
+			: g_{g}
+			, src_{src}
+			, edge_{edge} {}
+			// refers to the values in the file, nothing is copied
+			auto operator*() const noexcept -> ranges::common_tuple<N const&, N const&, E const&> {
+				return {g_->nodes_[src_], g_->nodes_[g_->dsts_[edge_]], g_->weights_[edge_]};
+			}
+			auto operator++() noexcept -> iterator& {
+				++edge_;
+				// skip the nodes whose edges all come before edge_, the ones without edges too
+				while (src_ < g_->nodes_.size() and g_->offsets_[src_ + 1] <= edge_) {
+					++src_;
+				}
+				return *this;
+			}
+			auto operator++(int) noexcept -> iterator {
+				auto temp = *this;
+				++*this;
+				return temp;
+			}
+			auto operator--() noexcept -> iterator& {
+				--edge_;
+				while (g_->offsets_[src_] > edge_) {
+					--src_;
+				}
+				return *this;
+			}
+			auto operator--(int) noexcept -> iterator {
+				auto temp = *this;
+				--*this;
+				return temp;
+			}
+			auto operator==(iterator const& other) const noexcept -> bool {
+				return edge_ == other.edge_;
+			}
+
+		private:
+			mapped_graph const* g_ = nullptr;
+			std::size_t src_ = 0;
+			std::size_t edge_ = 0;
+		};
+
+		// Constructors
+		explicit mapped_graph(std::filesystem::path const& path, file_check check = file_check::full)
+		: file_{path, caller} {
+			auto header = detail::file_header{};
+			if (file_.size() < sizeof(header)) {
+				detail::file_error(caller, "the file is not a graph file");
+			}
+			std::memcpy(&header, file_.data(), sizeof(header));
+			detail::check_header<N, E>(header, caller);
+			auto const n = static_cast<std::size_t>(header.node_count);
+			auto const e = static_cast<std::size_t>(header.edge_count);
+			auto const layout = detail::make_layout<N, E>(n, e);
+			if (file_.size() != layout.size) {
+				detail::file_error(caller, "the size of the file doesn't match its header");
+			}
+			if (check == file_check::full) {
+				auto sum = detail::checksum{};
+				sum.update(file_.data(), layout.checksum);
+				auto stored = std::uint64_t{};
+				std::memcpy(&stored, file_.data() + layout.checksum, sizeof(stored));
+				if (stored != sum.value()) {
+					detail::file_error(caller, "the checksum doesn't match");
+				}
+			}
+			// the sections are aligned arrays of trivially copyable values, written by write_binary
+			nodes_ = {reinterpret_cast<N const*>(file_.data() + layout.nodes), n};
+			offsets_ = {reinterpret_cast<std::uint64_t const*>(file_.data() + layout.offsets), n + 1};
+			dsts_ = {reinterpret_cast<std::uint32_t const*>(file_.data() + layout.dsts), e};
+			weights_ = {reinterpret_cast<E const*>(file_.data() + layout.weights), e};
+			if (check == file_check::full) {
+				detail::check_sections<N, E>(nodes_, offsets_, dsts_, weights_, caller);
+			}
+		} // O(1), or O(n + e) to check the checksum and the sections
+
+		// Accessors
+		[[nodiscard]] auto is_node(N const& value) const noexcept -> bool {
+			return position(value) != nodes_.size();
+		} // O(log(n))
+		[[nodiscard]] auto empty() const noexcept -> bool {
+			return nodes_.empty();
+		}
+		[[nodiscard]] auto is_connected(N const& src, N const& dst) const -> bool {
+			auto const s = position(src);
+			auto const d = position(dst);
+			if (s == nodes_.size() or d == nodes_.size()) {
+				throw std::runtime_error("Cannot call gdwg::mapped_graph<N, E>::is_connected if src "
+				                         "or dst node don't exist in the graph");
+			}
+			return std::binary_search(dsts_begin(s), dsts_end(s), d);
+		} // O(log(n) + log(d)), d is the out-degree of src
+		[[nodiscard]] auto nodes() const -> std::vector<N> {
+			return {nodes_.begin(), nodes_.end()};
+		} // O(n)
+		[[nodiscard]] auto weights(N const& src, N const& dst) const -> std::vector<E> {
+			auto const s = position(src);
+			auto const d = position(dst);
+			if (s == nodes_.size() or d == nodes_.size()) {
+				throw std::runtime_error("Cannot call gdwg::mapped_graph<N, E>::weights if src or "
+				                         "dst node don't exist in the graph");
+			}
+			auto const [first, last] = std::equal_range(dsts_begin(s), dsts_end(s), d);
+			return std::vector<E>(weights_.begin() + (first - dsts_.begin()),
+			                      weights_.begin() + (last - dsts_.begin()));
+		} // O(log(n) + log(d) + k), k is the number of edges from src to dst
+		[[nodiscard]] auto find(N const& src, N const& dst, E const& weight) const -> iterator {
+			auto const s = position(src);
+			auto const d = position(dst);
+			if (s == nodes_.size() or d == nodes_.size()) {
+				return end();
+			}
+			auto const [first, last] = std::equal_range(dsts_begin(s), dsts_end(s), d);
+			// the weights of the edges from src to dst are sorted too
+			auto const w_first = weights_.begin() + (first - dsts_.begin());
+			auto const w_last = weights_.begin() + (last - dsts_.begin());
+			auto const found = std::lower_bound(w_first, w_last, weight);
+			if (found == w_last or *found != weight) {
+				return end();
+			}
+			return iterator(this, s, static_cast<std::size_t>(found - weights_.begin()));
+		} // O(log(n) + log(d))
+		[[nodiscard]] auto connections(N const& src) const -> std::vector<N> {
+			auto const s = position(src);
+			if (s == nodes_.size()) {
+				throw std::runtime_error("Cannot call gdwg::mapped_graph<N, E>::connections if src "
+				                         "doesn't exist in the graph");
+			}
+			auto vec = std::vector<N>{};
+			for (auto iter = dsts_begin(s); iter != dsts_end(s); ++iter) {
+				if (iter == dsts_begin(s) or *iter != *(iter - 1)) { // edges to a dst are adjacent
+					vec.push_back(nodes_[*iter]);
+				}
+			}
+			return vec;
+		} // O(log(n) + d)
+
+		// Range access
+		[[nodiscard]] auto begin() const noexcept -> iterator {
+			// the first edge belongs to the last node whose edges start at 0
+			auto const first = std::upper_bound(offsets_.begin(), offsets_.end(), std::uint64_t{0});
+			return iterator(this, static_cast<std::size_t>(first - offsets_.begin()) - 1, 0);
+		}
+		[[nodiscard]] auto end() const noexcept -> iterator {
+			return iterator(this, nodes_.size(), dsts_.size());
+		}
+
+	private:
+		static constexpr auto caller = "gdwg::mapped_graph<N, E>::mapped_graph";
+
+		detail::file_mapping file_;
+		std::span<N const> nodes_{};
+		std::span<std::uint64_t const> offsets_{};
+		std::span<std::uint32_t const> dsts_{};
+		std::span<E const> weights_{};
+
+		// Returns the position of value in nodes_, or nodes_.size() if it is not a node.
+		[[nodiscard]] auto position(N const& value) const noexcept -> std::size_t {
+			auto const iter = std::lower_bound(nodes_.begin(), nodes_.end(), value);
+			if (iter == nodes_.end() or *iter != value) {
+				return nodes_.size();
+			}
+			return static_cast<std::size_t>(iter - nodes_.begin());
+		}
+		[[nodiscard]] auto dsts_begin(std::size_t src) const noexcept {
+			return dsts_.begin() + static_cast<std::ptrdiff_t>(offsets_[src]);
+		}
+		[[nodiscard]] auto dsts_end(std::size_t src) const noexcept {
+			return dsts_.begin() + static_cast<std::ptrdiff_t>(offsets_[src + 1]);
+		}
+	};
+} // namespace gdwg
+
+#endif // GDWG_MAPPED_GRAPH_HPP
@@ -0,0 +1,69 @@
+#ifndef GDWG_PARALLEL_GRAPH_HPP
+#define GDWG_PARALLEL_GRAPH_HPP
+
+#include <algorithm>
+#include <execution>
+#include <memory_resource>
+#include <range/v3/iterator.hpp>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "gdwg/graph.hpp"
+
+// Building a graph under an execution policy lives apart from graph.hpp: the parallel algorithms
+// of libstdc++ run on TBB, and a program that includes <execution> links against it.
+namespace gdwg {
+	namespace detail {
+		// The algorithms a bulk load runs, run under policy.
+		template<typename ExecutionPolicy>
+		struct policy_algorithms {
+			ExecutionPolicy const& policy;
+
+			template<typename... Args>
+			auto sort(Args&&... args) const -> void {
+				std::sort(policy, std::forward<Args>(args)...);
+			}
+			template<typename... Args>
+			auto transform(Args&&... args) const {
+				return std::transform(policy, std::forward<Args>(args)...);
+			}
+			template<typename... Args>
+			auto unique(Args&&... args) const {
+				return std::unique(policy, std::forward<Args>(args)...);
+			}
+		};
+	} // namespace detail
+
+	// Builds the same graph as graph<N, E, Storage>(first, last, resource), running the sorts and
+	// node lookups of the bulk load under policy, such as std::execution::par_unseq. Only reading
+	// the range and filling the sets from the sorted edges stay serial, both are O(e).
+	template<typename N,
+	         typename E,
+	         typename Storage = tree_storage,
+	         typename ExecutionPolicy,
+	         ranges::input_iterator I,
+	         ranges::sentinel_for<I> S>
+	requires std::is_execution_policy_v<std::remove_cvref_t<ExecutionPolicy>>
+	   and ranges::indirectly_copyable<I, typename graph<N, E, Storage>::value_type*>
+	auto build_graph(ExecutionPolicy&& policy,
+	                 I first,
+	                 S last,
+	                 std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+	   -> graph<N, E, Storage> {
+		auto edges = std::vector<typename graph<N, E, Storage>::value_type>{};
+		for (; first != last; ++first) {
+			edges.push_back(*first);
+		}
+		auto g = graph<N, E, Storage>(resource);
+		using algorithms = detail::policy_algorithms<std::remove_cvref_t<ExecutionPolicy>>;
+		detail::graph_access::bulk_load(g,
+		                                "gdwg::build_graph",
+		                                edges,
+		                                std::vector<N>{},
+		                                algorithms{policy});
+		return g;
+	} // O(e log(e) / p + e), p is the number of threads policy runs on
+} // namespace gdwg
+
+#endif // GDWG_PARALLEL_GRAPH_HPP
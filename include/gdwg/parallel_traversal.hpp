@@ -0,0 +1,163 @@
+#ifndef GDWG_PARALLEL_TRAVERSAL_HPP
+#define GDWG_PARALLEL_TRAVERSAL_HPP
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <execution>
+#include <functional>
+#include <numeric>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "gdwg/graph.hpp"
+#include "gdwg/traversal.hpp"
+
+// The parallel search lives apart from traversal.hpp for the same reason build_graph lives apart
+// from graph.hpp: the parallel algorithms of libstdc++ run on TBB, and a program that includes
+// <execution> links against it.
+namespace gdwg {
+	namespace detail {
+		// The breadth-first search of reachable_from(policy, t, src), on the bitsets of t.
+		struct parallel_reachable {
+			// Beamer, Asanovic and Patterson's alpha and beta.
+			static constexpr auto top_down_limit = std::size_t{14};
+			static constexpr auto bottom_up_limit = std::size_t{24};
+
+			template<typename ExecutionPolicy, typename N, typename E, typename Storage>
+			[[nodiscard]] static auto
+			run(ExecutionPolicy const& policy, traversal<N, E, Storage>& t, N const& src)
+			   -> std::vector<N> {
+				using access = graph_access;
+				auto const source = t.start(src, "reachable_from");
+				auto const& g = *t.g_;
+				auto const n = access::nodes(g).size();
+				t.visited_.assign(access::id_count(g));
+				for (auto const id : access::free_ids(g)) {
+					t.visited_.set(static_cast<std::size_t>(id)); // never asked about, never reached
+				}
+				t.frontier_.assign(access::id_count(g));
+				t.next_.assign(access::id_count(g));
+				t.visited_.set(source);
+				t.frontier_.set(source);
+				auto frontier_size = std::size_t{1};
+				auto unreached = n - 1;
+				auto bottom_up = false;
+				while (frontier_size > 0) {
+					// Beamer's switch, with the edges of a set of nodes taken as proportional to its
+					// size
+					if (!bottom_up and frontier_size * top_down_limit > unreached) {
+						bottom_up = true;
+					}
+					else if (bottom_up and frontier_size * bottom_up_limit < n) {
+						bottom_up = false;
+					}
+					auto& next = t.next_.words();
+					if (bottom_up) {
+						std::for_each(policy, next.begin(), next.end(), [&t, &g, &next](auto& word) {
+							word = grow_bottom_up(t, g, static_cast<std::size_t>(&word - next.data()));
+						});
+					}
+					else {
+						std::fill(next.begin(), next.end(), 0);
+						auto const& frontier = t.frontier_.words();
+						std::for_each(policy, frontier.begin(), frontier.end(), [&](auto const& word) {
+							grow_top_down(t,
+							              g,
+							              word,
+							              static_cast<std::size_t>(&word - frontier.data()));
+						});
+					}
+					// both ways only ever add unreached nodes to the next level
+					auto& visited = t.visited_.words();
+					std::for_each(policy, next.begin(), next.end(), [&next, &visited](auto const& word) {
+						visited[static_cast<std::size_t>(&word - next.data())] |= word;
+					});
+					frontier_size = std::transform_reduce(policy,
+					                                      next.begin(),
+					                                      next.end(),
+					                                      std::size_t{0},
+					                                      std::plus<>{},
+					                                      [](auto const word) {
+						                                      return static_cast<std::size_t>(
+						                                         std::popcount(word));
+					                                      });
+					unreached -= frontier_size;
+					std::swap(t.frontier_, t.next_);
+				}
+				for (auto const id : access::free_ids(g)) {
+					t.visited_.reset(static_cast<std::size_t>(id));
+				}
+				auto vec = std::vector<N>{};
+				vec.reserve(n - unreached);
+				auto& visited = t.visited_.words();
+				for (auto w = std::size_t{0}; w < visited.size(); ++w) {
+					for_each_bit(visited[w], w, [&vec, &g](std::size_t id) {
+						vec.push_back(access::value(g, static_cast<node_id>(id)));
+					});
+				}
+				std::fill(visited.begin(), visited.end(), 0); // as the serial searches expect it
+				std::sort(vec.begin(), vec.end());
+				return vec;
+			}
+
+			// Marks the unreached nodes that the nodes of one word of the frontier lead to.
+			template<typename T, typename G>
+			static auto grow_top_down(T& t, G const& g, std::uint64_t word, std::size_t w) -> void {
+				for_each_bit(word, w, [&t, &g](std::size_t u) {
+					for (auto const& edge : graph_access::out_edges(g, static_cast<node_id>(u))) {
+						auto const v = static_cast<std::size_t>(edge.dst);
+						if (!t.visited_.test(v)) {
+							t.next_.set_shared(v);
+						}
+					}
+				});
+			}
+			// Returns the word w of the next frontier: the unreached nodes among its ids that an
+			// edge from the frontier leads to. Ids of erased nodes have no edges and are never
+			// reached.
+			template<typename T, typename G>
+			[[nodiscard]] static auto grow_bottom_up(T const& t, G const& g, std::size_t w)
+			   -> std::uint64_t {
+				auto word = std::uint64_t{0};
+				auto const first = w * id_bitset::word_bits;
+				auto const last = std::min(first + id_bitset::word_bits, graph_access::id_count(g));
+				for (auto v = first; v < last; ++v) {
+					if (t.visited_.test(v)) {
+						continue;
+					}
+					for (auto const& edge : graph_access::in_edges(g, static_cast<node_id>(v))) {
+						if (t.frontier_.test(static_cast<std::size_t>(edge.src))) {
+							word |= std::uint64_t{1} << (v - first);
+							break; // one edge from the frontier is enough
+						}
+					}
+				}
+				return word;
+			}
+		};
+	} // namespace detail
+
+	// Returns the same nodes as t.reachable_from(src), found by a breadth-first search that runs
+	// each level under policy. A level is grown top-down, from the edges out of its nodes, while it
+	// is small, and bottom-up, by asking every unreached node whether an edge into it comes from
+	// the level, once it holds a large part of the graph: then most of the edges out of the level
+	// lead to nodes that were already reached, and looking at them is wasted. Levels are bitsets,
+	// and threads share out their words. Threads set bits of the next level at the same time, so
+	// policy is std::execution::seq or std::execution::par, never an unsequenced one.
+	template<typename ExecutionPolicy, typename N, typename E, typename Storage>
+	requires std::is_execution_policy_v<std::remove_cvref_t<ExecutionPolicy>>
+	[[nodiscard]] auto reachable_from(ExecutionPolicy&& policy,
+	                                  traversal<N, E, Storage>& t,
+	                                  std::type_identity_t<N> const& src) -> std::vector<N> {
+		using policy_type = std::remove_cvref_t<ExecutionPolicy>;
+		static_assert(std::is_same_v<policy_type, std::execution::sequenced_policy>
+		                 or std::is_same_v<policy_type, std::execution::parallel_policy>,
+		              "unsequenced policies forbid the atomic operations that build the levels");
+		return detail::parallel_reachable::run(policy, t, src);
+	} // O(log(n) + d (n / 64 + e log(e)) / p + r log(r)), d levels on p threads
+} // namespace gdwg
+
+#endif // GDWG_PARALLEL_TRAVERSAL_HPP
@@ -0,0 +1,344 @@
+#ifndef GDWG_SHORTEST_PATHS_HPP
+#define GDWG_SHORTEST_PATHS_HPP
+
+#include <algorithm>
+#include <concepts>
+#include <concepts/concepts.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gdwg/graph.hpp"
+
+namespace gdwg {
+	// Weights that can be added up into the length of a path, starting from E{}.
+	template<typename E>
+	concept path_weight = concepts::totally_ordered<E> and requires(E const& lhs, E const& rhs) {
+		{ lhs + rhs } -> std::convertible_to<E>;
+	};
+
+	namespace detail {
+		constexpr auto no_parent = std::numeric_limits<std::uint32_t>::max();
+
+		// The shortest path tree the algorithms below build, indexed by node id: dist[i] is only
+		// meaningful when parent[i] is not no_parent, and the source starts as its own parent.
+		template<typename E>
+		struct path_tree {
+			std::size_t source;
+			std::vector<E> dist;
+			std::vector<std::uint32_t> parent;
+			std::vector<bool> unbounded{}; // nodes a negative cycle leads to, Bellman-Ford only
+			std::vector<std::uint32_t> cycle{}; // one negative cycle, in path order
+
+			path_tree(std::size_t id_count, std::size_t src)
+			: source{src}
+			, dist(id_count)
+			, parent(id_count, no_parent) {
+				parent[source] = static_cast<std::uint32_t>(source);
+			}
+		};
+
+		// A d-ary min-heap of node ids, ordered by their distance, that can move an id up when its
+		// distance goes down. Its arrays are sized once, so a search never allocates while it runs.
+		// Four children per node make the heap half as deep as a binary heap, for the price of more
+		// comparisons in pop, which is the usual trade when decreases outnumber pops.
+		template<typename E, std::size_t D = 4>
+		class indexed_heap {
+		public:
+			explicit indexed_heap(std::vector<E> const& dist)
+			: dist_{&dist}
+			, positions_(dist.size(), absent) {
+				heap_.reserve(dist.size());
+			}
+			[[nodiscard]] auto empty() const noexcept -> bool {
+				return heap_.empty();
+			}
+			// Inserts id, or moves it up if it is already there and its distance went down.
+			auto push_or_decrease(std::uint32_t id) noexcept -> void {
+				if (positions_[id] == absent) {
+					positions_[id] = heap_.size();
+					heap_.push_back(id); // never reallocates
+				}
+				sift_up(positions_[id]);
+			} // O(log(n))
+			auto pop() noexcept -> std::uint32_t {
+				auto const top = heap_.front();
+				positions_[top] = absent;
+				heap_.front() = heap_.back();
+				heap_.pop_back();
+				if (!heap_.empty()) {
+					positions_[heap_.front()] = 0;
+					sift_down(0);
+				}
+				return top;
+			} // O(D log(n))
+
+		private:
+			static constexpr auto absent = std::numeric_limits<std::size_t>::max();
+			std::vector<E> const* dist_;
+			std::vector<std::size_t> positions_; // of every id in heap_, or absent
+			std::vector<std::uint32_t> heap_{};
+
+			[[nodiscard]] auto less(std::uint32_t lhs, std::uint32_t rhs) const noexcept -> bool {
+				return (*dist_)[lhs] < (*dist_)[rhs];
+			}
+			auto place(std::size_t position, std::uint32_t id) noexcept -> void {
+				heap_[position] = id;
+				positions_[id] = position;
+			}
+			auto sift_up(std::size_t position) noexcept -> void {
+				auto const id = heap_[position];
+				while (position > 0 and less(id, heap_[(position - 1) / D])) {
+					place(position, heap_[(position - 1) / D]);
+					position = (position - 1) / D;
+				}
+				place(position, id);
+			}
+			auto sift_down(std::size_t position) noexcept -> void {
+				auto const id = heap_[position];
+				for (;;) {
+					auto const first = D * position + 1;
+					if (first >= heap_.size()) {
+						break;
+					}
+					auto const last = std::min(first + D, heap_.size());
+					auto best = first;
+					for (auto child = first + 1; child < last; ++child) {
+						if (less(heap_[child], heap_[best])) {
+							best = child;
+						}
+					}
+					if (!less(heap_[best], id)) {
+						break;
+					}
+					place(position, heap_[best]);
+					position = best;
+				}
+				place(position, id);
+			}
+		};
+	} // namespace detail
+
+	// The shortest paths from one source to every node of a graph, as they were when they were
+	// computed. Nodes are looked up by binary search, like in csr_graph, so the result does not
+	// depend on the graph staying alive or unchanged.
+	template<concepts::regular N, path_weight E>
+	requires concepts::totally_ordered<N> class shortest_paths {
+	public:
+		template<typename Storage>
+		shortest_paths(graph<N, E, Storage> const& g, detail::path_tree<E> tree) {
+			using access = detail::graph_access;
+			auto const& ids = access::nodes(g);
+			// maps ids to positions in nodes_, which are in value order
+			auto positions = std::vector<std::uint32_t>(access::id_count(g), detail::no_parent);
+			nodes_.reserve(ids.size());
+			for (auto const id : ids) {
+				positions[static_cast<std::size_t>(id)] = static_cast<std::uint32_t>(nodes_.size());
+				nodes_.push_back(access::value(g, id));
+			}
+			dist_.reserve(nodes_.size());
+			parent_.reserve(nodes_.size());
+			for (auto const id : ids) {
+				auto const i = static_cast<std::size_t>(id);
+				dist_.push_back(std::move(tree.dist[i]));
+				auto const parent = tree.parent[i];
+				parent_.push_back(parent == detail::no_parent ? parent : positions[parent]);
+				unbounded_.push_back(!tree.unbounded.empty() and tree.unbounded[i]);
+			}
+			source_ = positions[tree.source];
+			for (auto const i : tree.cycle) {
+				cycle_.push_back(nodes_[positions[i]]);
+			}
+		} // O(n)
+
+		[[nodiscard]] auto source() const noexcept -> N const& {
+			return nodes_[source_];
+		}
+		[[nodiscard]] auto reachable(N const& dst) const -> bool {
+			return parent_[position(dst, "reachable")] != detail::no_parent;
+		} // O(log(n))
+		// Returns the length of the shortest path to dst, or nothing if there is no path to it.
+		[[nodiscard]] auto distance(N const& dst) const -> std::optional<E> {
+			auto const d = bounded_position(dst, "distance");
+			if (parent_[d] == detail::no_parent) {
+				return std::nullopt;
+			}
+			return dist_[d];
+		} // O(log(n))
+		// Returns the nodes of the shortest path to dst, from the source to dst, or nothing if there
+		// is no path to it.
+		[[nodiscard]] auto path(N const& dst) const -> std::vector<N> {
+			auto vec = std::vector<N>{};
+			auto i = bounded_position(dst, "path");
+			if (parent_[i] == detail::no_parent) {
+				return vec;
+			}
+			vec.push_back(nodes_[i]);
+			for (; i != source_; i = parent_[i]) {
+				vec.push_back(nodes_[parent_[i]]);
+			}
+			std::reverse(vec.begin(), vec.end());
+			return vec;
+		} // O(log(n) + k), k is the number of edges of the path
+		// Returns the nodes of a negative cycle that the source leads to, in path order, or nothing
+		// if there is none. Paths to the nodes such a cycle leads to have no shortest length.
+		[[nodiscard]] auto negative_cycle() const noexcept -> std::vector<N> const& {
+			return cycle_;
+		}
+
+	private:
+		std::vector<N> nodes_{};
+		std::vector<E> dist_{};
+		std::vector<std::uint32_t> parent_{}; // positions in nodes_, or no_parent if unreachable
+		std::vector<bool> unbounded_{};
+		std::vector<N> cycle_{};
+		std::size_t source_ = 0;
+
+		[[nodiscard]] auto position(N const& value, char const* function) const -> std::size_t {
+			auto const iter = std::lower_bound(nodes_.begin(), nodes_.end(), value);
+			if (iter == nodes_.end() or *iter != value) {
+				throw std::runtime_error(std::string("Cannot call gdwg::shortest_paths<N, E>::")
+				                         + function + " if dst doesn't exist in the graph");
+			}
+			return static_cast<std::size_t>(iter - nodes_.begin());
+		}
+		[[nodiscard]] auto bounded_position(N const& value, char const* function) const
+		   -> std::size_t {
+			auto const i = position(value, function);
+			if (unbounded_[i]) {
+				throw std::runtime_error(std::string("Cannot call gdwg::shortest_paths<N, E>::")
+				                         + function + " if a negative cycle leads to dst");
+			}
+			return i;
+		}
+	};
+
+	// Dijkstra's algorithm over an indexed 4-ary heap, reading the outgoing edges of every node in
+	// place. The edges from a node to the same dst are adjacent and sorted by weight, so only the
+	// first of them is relaxed. Throws if it reaches an edge with a negative weight.
+	template<concepts::regular N, path_weight E, typename Storage>
+	[[nodiscard]] auto dijkstra(graph<N, E, Storage> const& g, N const& src)
+	   -> shortest_paths<N, E> {
+		using access = detail::graph_access;
+		auto const source = access::id(g, src);
+		if (source == access::id_count(g)) {
+			throw std::runtime_error("Cannot call gdwg::dijkstra if src doesn't exist in the graph");
+		}
+		auto tree = detail::path_tree<E>(access::id_count(g), source);
+		auto& dist = tree.dist;
+		auto& parent = tree.parent;
+		dist[source] = E{};
+		auto heap = detail::indexed_heap<E>(dist);
+		auto done = std::vector<bool>(dist.size());
+		heap.push_or_decrease(static_cast<std::uint32_t>(source));
+		while (!heap.empty()) {
+			auto const u = heap.pop();
+			done[u] = true;
+			auto const* previous = static_cast<node_id const*>(nullptr);
+			for (auto const& edge : access::out_edges(g, static_cast<node_id>(u))) {
+				if (previous != nullptr and *previous == edge.dst) {
+					continue; // a heavier edge to the same dst
+				}
+				previous = &edge.dst;
+				if (edge.edge < E{}) {
+					throw std::runtime_error("Cannot call gdwg::dijkstra if a reachable edge has a "
+					                         "negative weight");
+				}
+				auto const v = static_cast<std::uint32_t>(edge.dst);
+				if (done[v]) {
+					continue;
+				}
+				auto length = dist[u] + edge.edge;
+				if (parent[v] == detail::no_parent or length < dist[v]) {
+					dist[v] = std::move(length);
+					parent[v] = u;
+					heap.push_or_decrease(v);
+				}
+			}
+		}
+		return shortest_paths<N, E>(g, std::move(tree));
+	} // O((n + e) log(n))
+
+	// Bellman-Ford, in rounds over the whole edge set in its own order, which is a walk over
+	// contiguous memory with flat_storage. It stops at the first round that changes nothing. If
+	// the n-th round still shortens a path, the source leads to a negative cycle: the result names
+	// one, and every node reachable from the nodes that round shortened has no shortest path.
+	template<concepts::regular N, path_weight E, typename Storage>
+	[[nodiscard]] auto bellman_ford(graph<N, E, Storage> const& g, N const& src)
+	   -> shortest_paths<N, E> {
+		using access = detail::graph_access;
+		auto const source = access::id(g, src);
+		if (source == access::id_count(g)) {
+			throw std::runtime_error("Cannot call gdwg::bellman_ford if src doesn't exist in the "
+			                         "graph");
+		}
+		auto tree = detail::path_tree<E>(access::id_count(g), source);
+		auto& dist = tree.dist;
+		auto& parent = tree.parent;
+		dist[source] = E{};
+		auto const& edges = access::edges(g);
+		auto const n = access::nodes(g).size();
+		auto relaxed = std::vector<std::uint32_t>{}; // the nodes shortened in the n-th round
+		for (auto round = std::size_t{1}; round <= n; ++round) {
+			auto changed = false;
+			for (auto const& edge : edges) {
+				auto const u = static_cast<std::uint32_t>(edge.src);
+				auto const v = static_cast<std::uint32_t>(edge.dst);
+				if (parent[u] == detail::no_parent) {
+					continue;
+				}
+				auto length = dist[u] + edge.edge;
+				if (parent[v] == detail::no_parent or length < dist[v]) {
+					dist[v] = std::move(length);
+					parent[v] = u;
+					changed = true;
+					if (round == n) {
+						relaxed.push_back(v);
+					}
+				}
+			}
+			if (!changed) {
+				break;
+			}
+		}
+		if (relaxed.empty()) {
+			return shortest_paths<N, E>(g, std::move(tree));
+		}
+		// n steps back from a node the last round shortened always end up on a cycle
+		auto on_cycle = relaxed.back();
+		for (auto i = std::size_t{0}; i < n; ++i) {
+			on_cycle = parent[on_cycle];
+		}
+		for (auto i = on_cycle;;) {
+			tree.cycle.push_back(i);
+			i = parent[i];
+			if (i == on_cycle) {
+				break;
+			}
+		}
+		std::reverse(tree.cycle.begin(), tree.cycle.end());
+		tree.unbounded.assign(dist.size(), false);
+		for (auto const i : relaxed) {
+			tree.unbounded[i] = true;
+		}
+		while (!relaxed.empty()) { // depth first through everything they lead to
+			auto const u = relaxed.back();
+			relaxed.pop_back();
+			for (auto const& edge : access::out_edges(g, static_cast<node_id>(u))) {
+				auto const v = static_cast<std::size_t>(edge.dst);
+				if (!tree.unbounded[v]) {
+					tree.unbounded[v] = true;
+					relaxed.push_back(static_cast<std::uint32_t>(v));
+				}
+			}
+		}
+		return shortest_paths<N, E>(g, std::move(tree));
+	} // O(n e), O(r e) when every shortest path has fewer than r edges
+} // namespace gdwg
+
+#endif // GDWG_SHORTEST_PATHS_HPP
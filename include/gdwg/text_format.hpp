@@ -0,0 +1,297 @@
+#ifndef GDWG_TEXT_FORMAT_HPP
+#define GDWG_TEXT_FORMAT_HPP
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <concepts>
+#include <cstddef>
+#include <cstring>
+#include <fmt/format.h>
+#include <fmt/ostream.h>
+#include <istream>
+#include <iterator>
+#include <memory_resource>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+#include <unistd.h>
+
+#include "gdwg/graph.hpp"
+
+// The text format is the one operator<< writes: every node, in order, on a line of its own
+// followed by " (", then one line "  dst | weight" for each of its outgoing edges, in order, and
+// a line ")" to close it. parse_graph reads it, and write_graph writes it faster than operator<<.
+namespace gdwg {
+	namespace detail {
+		template<typename T>
+		concept character = std::same_as<std::remove_cv_t<T>, char>
+		                    or std::same_as<std::remove_cv_t<T>, signed char>
+		                    or std::same_as<std::remove_cv_t<T>, unsigned char>
+		                    or std::same_as<std::remove_cv_t<T>, wchar_t>
+		                    or std::same_as<std::remove_cv_t<T>, char8_t>
+		                    or std::same_as<std::remove_cv_t<T>, char16_t>
+		                    or std::same_as<std::remove_cv_t<T>, char32_t>;
+	} // namespace detail
+
+	// Values that are read back from the text operator<< writes for them: strings, which are
+	// written as they are, and numbers. Characters and bools are written as something else than
+	// numbers, and floating point numbers only keep the 6 digits operator<< writes of them.
+	template<typename T>
+	concept text_value = std::same_as<T, std::string> or std::floating_point<T>
+	                     or (std::integral<T> and !std::same_as<T, bool> and !detail::character<T>);
+
+	namespace detail {
+		template<typename T>
+		auto parse_value(std::string_view text, T& value) -> bool {
+			if constexpr (std::same_as<T, std::string>) {
+				value.assign(text);
+				return true;
+			}
+			else {
+				auto const* const last = text.data() + text.size();
+				auto const [end, error] = std::from_chars(text.data(), last, value);
+				return error == std::errc{} and end == last;
+			}
+		}
+
+		// The lines of a text, without their line breaks.
+		class text_lines {
+		public:
+			explicit text_lines(std::string_view text) noexcept
+			: text_{text} {}
+			auto next(std::string_view& line) noexcept -> bool {
+				if (text_.empty()) {
+					return false;
+				}
+				auto const end = std::min(text_.find('\n'), text_.size());
+				line = text_.substr(0, end);
+				text_.remove_prefix(std::min(end + 1, text_.size()));
+				return true;
+			}
+
+		private:
+			std::string_view text_;
+		};
+
+		// The lines of a stream, read a chunk at a time into a buffer, which only grows to hold a
+		// line longer than itself. A line is valid until the next one is read.
+		class stream_lines {
+		public:
+			explicit stream_lines(std::istream& is)
+			: is_{&is} {}
+			auto next(std::string_view& line) -> bool {
+				for (;;) {
+					auto const rest = std::string_view(buffer_.data() + first_, last_ - first_);
+					auto const end = rest.find('\n');
+					if (end != std::string_view::npos) {
+						line = rest.substr(0, end);
+						first_ += end + 1;
+						return true;
+					}
+					if (done_) {
+						line = rest;
+						first_ = last_;
+						return !rest.empty();
+					}
+					refill();
+				}
+			}
+
+		private:
+			std::istream* is_;
+			std::vector<char> buffer_ = std::vector<char>(std::size_t{1} << 20);
+			std::size_t first_ = 0; // the unread part of the buffer is [first_, last_)
+			std::size_t last_ = 0;
+			bool done_ = false;
+
+			auto refill() -> void {
+				// the start of the line that runs past the buffer moves to its front
+				std::copy(buffer_.begin() + static_cast<std::ptrdiff_t>(first_),
+				          buffer_.begin() + static_cast<std::ptrdiff_t>(last_),
+				          buffer_.begin());
+				last_ -= first_;
+				first_ = 0;
+				if (last_ == buffer_.size()) {
+					buffer_.resize(2 * buffer_.size());
+				}
+				is_->read(buffer_.data() + last_, static_cast<std::streamsize>(buffer_.size() - last_));
+				last_ += static_cast<std::size_t>(is_->gcount());
+				done_ = !*is_;
+			}
+		};
+
+		[[noreturn]] inline auto malformed(std::size_t line) -> void {
+			throw std::runtime_error("Cannot call gdwg::parse_graph if line " + std::to_string(line)
+			                         + " is malformed");
+		}
+
+		// Parses the text format line by line, collecting the edges to bulk-load them at the end.
+		template<typename N, typename E, typename Storage, typename Lines>
+		auto parse_lines(Lines& lines, std::pmr::memory_resource* resource) -> graph<N, E, Storage> {
+			using value_type = typename graph<N, E, Storage>::value_type;
+			auto edges = std::vector<value_type>{};
+			auto lonely = std::vector<N>{}; // nodes without outgoing edges, which no edge may add
+			auto edge = value_type{};
+			auto line = std::string_view{};
+			auto number = std::size_t{0};
+			auto in_node = false; // between the line of a node and its ")"
+			auto has_edges = false;
+			while (lines.next(line)) {
+				++number;
+				if (!in_node) {
+					if (!line.ends_with(" (")
+					    or !parse_value(line.substr(0, line.size() - 2), edge.from))
+					{
+						malformed(number);
+					}
+					in_node = true;
+					has_edges = false;
+				}
+				else if (line == ")") {
+					if (!has_edges) {
+						lonely.push_back(edge.from);
+					}
+					in_node = false;
+				}
+				else {
+					// a string dst may hold " | " too, so the weight is what follows the last one
+					auto const bar = line.rfind(" | ");
+					if (!line.starts_with("  ") or bar == std::string_view::npos or bar < 2
+					    or !parse_value(line.substr(2, bar - 2), edge.to)
+					    or !parse_value(line.substr(bar + 3), edge.weight))
+					{
+						malformed(number);
+					}
+					edges.push_back(edge);
+					has_edges = true;
+				}
+			}
+			if (in_node) {
+				malformed(number + 1); // the ")" is missing
+			}
+			auto g = graph<N, E, Storage>(resource);
+			graph_access::bulk_load(g, "gdwg::parse_graph", edges, lonely);
+			return g;
+		} // O(l + e log(e)), l is the length of the text
+	} // namespace detail
+
+	// Reads back the graph operator<< wrote into text, without going through a stream.
+	template<text_value N, text_value E, typename Storage = tree_storage>
+	auto parse_graph(std::string_view text,
+	                 std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+	   -> graph<N, E, Storage> {
+		auto lines = detail::text_lines(text);
+		return detail::parse_lines<N, E, Storage>(lines, resource);
+	} // O(l + e log(e)), l is the length of the text
+
+	// Reads back the graph operator<< wrote into is, which is read in chunks of 1MiB: besides the
+	// edges it collects, parsing holds the longest line or 1MiB of text, whichever is more.
+	template<text_value N, text_value E, typename Storage = tree_storage>
+	auto parse_graph(std::istream& is,
+	                 std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+	   -> graph<N, E, Storage> {
+		auto lines = detail::stream_lines(is);
+		return detail::parse_lines<N, E, Storage>(lines, resource);
+	} // O(l + e log(e)), l is the length of the text
+
+	namespace detail {
+		// The pieces of a line are a few bytes each, a resize and a copy are cheaper than the loop of
+		// memory_buffer::append.
+		inline auto append(fmt::memory_buffer& buffer, std::string_view text) -> void {
+			auto const size = buffer.size();
+			buffer.resize(size + text.size());
+			std::memcpy(buffer.data() + size, text.data(), text.size());
+		}
+
+		// Formats value exactly as operator<< on a default std::ostream does: numbers and strings
+		// through fmt, and everything else through its own operator<<.
+		template<typename T>
+		auto append_value(fmt::memory_buffer& buffer, T const& value) -> void {
+			auto out = std::back_inserter(buffer);
+			if constexpr (std::same_as<T, bool>) {
+				fmt::format_to(out, "{:d}", value);
+			}
+			else if constexpr (std::floating_point<T>) {
+				fmt::format_to(out, "{:g}", value); // the 6 significant digits of a stream
+			}
+			else if constexpr (character<T>) {
+				fmt::format_to(out, "{}", static_cast<char>(value)); // a stream writes chars as chars
+			}
+			else if constexpr (std::integral<T>) {
+				auto const digits = fmt::format_int(value);
+				append(buffer, std::string_view(digits.data(), digits.size()));
+			}
+			else if constexpr (std::convertible_to<T const&, std::string_view>) {
+				append(buffer, value);
+			}
+			else {
+				fmt::format_to(out, "{}", fmt::streamed(value));
+			}
+		}
+
+		// Writes all of text to fd, in as many calls to write as that takes.
+		inline auto write_all(int fd, std::string_view text) -> void {
+			while (!text.empty()) {
+				auto const written = ::write(fd, text.data(), text.size());
+				if (written == -1 and errno == EINTR) {
+					continue;
+				}
+				if (written <= 0) {
+					throw std::runtime_error("Cannot call gdwg::write_graph if the file descriptor "
+					                         "can't be written");
+				}
+				text.remove_prefix(static_cast<std::size_t>(written));
+			}
+		}
+	} // namespace detail
+
+	// Writes the same text as operator<<, byte for byte, formatting it into one buffer that is
+	// handed to sink, as a std::string_view, whenever it holds 64KiB, and reused.
+	template<typename N, typename E, typename Storage, typename Sink>
+	requires std::invocable<Sink&, std::string_view>
+	auto write_graph(graph<N, E, Storage> const& g, Sink&& sink) -> void {
+		constexpr auto flush_size = std::size_t{1} << 16;
+		using access = detail::graph_access;
+		auto const& edges = access::edges(g);
+		auto buffer = fmt::memory_buffer{};
+		auto const flush = [&buffer, &sink] {
+			sink(std::string_view(buffer.data(), buffer.size()));
+			buffer.clear();
+		};
+		auto edge = edges.begin();
+		for (auto const id : access::nodes(g)) {
+			detail::append_value(buffer, access::value(g, id));
+			detail::append(buffer, " (\n");
+			for (; edge != edges.end() and edge->src == id; ++edge) {
+				detail::append(buffer, "  ");
+				detail::append_value(buffer, access::value(g, edge->dst));
+				detail::append(buffer, " | ");
+				detail::append_value(buffer, edge->edge);
+				detail::append(buffer, "\n");
+				if (buffer.size() >= flush_size) {
+					flush();
+				}
+			}
+			detail::append(buffer, ")\n");
+			if (buffer.size() >= flush_size) {
+				flush();
+			}
+		}
+		if (buffer.size() > 0) {
+			flush();
+		}
+	} // O(n + e)
+
+	// Writes the same text as operator<< straight to the file descriptor fd, 64KiB at a time.
+	template<typename N, typename E, typename Storage>
+	auto write_graph(graph<N, E, Storage> const& g, int fd) -> void {
+		write_graph(g, [fd](std::string_view text) { detail::write_all(fd, text); });
+	} // O(n + e)
+} // namespace gdwg
+
+#endif // GDWG_TEXT_FORMAT_HPP
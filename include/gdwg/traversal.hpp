@@ -0,0 +1,246 @@
+#ifndef GDWG_TRAVERSAL_HPP
+#define GDWG_TRAVERSAL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <concepts/concepts.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "gdwg/graph.hpp"
+
+namespace gdwg {
+	namespace detail {
+		struct parallel_reachable;
+
+		// One bit per node id, in words that the parallel search hands to threads one at a time.
+		class id_bitset {
+		public:
+			static constexpr auto word_bits = std::size_t{64};
+
+			// Makes room for ids below count, all unset.
+			auto assign(std::size_t count) -> void {
+				words_.assign((count + word_bits - 1) / word_bits, 0);
+			}
+			[[nodiscard]] auto test(std::size_t id) const noexcept -> bool {
+				return (words_[id / word_bits] & mask(id)) != 0;
+			}
+			// Returns whether the bit was unset.
+			auto set(std::size_t id) noexcept -> bool {
+				auto& word = words_[id / word_bits];
+				auto const unset = (word & mask(id)) == 0;
+				word |= mask(id);
+				return unset;
+			}
+			// Like set, for bits that other threads may be setting at the same time.
+			auto set_shared(std::size_t id) noexcept -> bool {
+				auto const word = std::atomic_ref<std::uint64_t>(words_[id / word_bits]);
+				return (word.fetch_or(mask(id), std::memory_order_relaxed) & mask(id)) == 0;
+			}
+			auto reset(std::size_t id) noexcept -> void {
+				words_[id / word_bits] &= ~mask(id);
+			}
+			[[nodiscard]] auto words() noexcept -> std::vector<std::uint64_t>& {
+				return words_;
+			}
+			[[nodiscard]] auto words() const noexcept -> std::vector<std::uint64_t> const& {
+				return words_;
+			}
+
+		private:
+			std::vector<std::uint64_t> words_{};
+
+			[[nodiscard]] static auto mask(std::size_t id) noexcept -> std::uint64_t {
+				return std::uint64_t{1} << (id % id_bitset::word_bits);
+			}
+		};
+
+		// Calls f with every set bit of word, the word at index w of a bitset.
+		template<typename F>
+		auto for_each_bit(std::uint64_t word, std::size_t w, F f) -> void {
+			while (word != 0) {
+				f(w * id_bitset::word_bits + static_cast<std::size_t>(std::countr_zero(word)));
+				word &= word - 1;
+			}
+		}
+	} // namespace detail
+
+	// Searches a graph from one node at a time, on node ids and bitsets rather than on node values.
+	// The buffers of a search are kept for the next one, so that after the first search of a size
+	// a query only allocates for what it returns. A traversal must not outlive its graph, and the
+	// graph must not be modified during a search. One traversal serves one thread at a time.
+	template<concepts::regular N, concepts::regular E, typename Storage = tree_storage>
+	requires concepts::totally_ordered<N>and concepts::totally_ordered<E> class traversal {
+	public:
+		using graph_type = graph<N, E, Storage>;
+
+		explicit traversal(graph_type const& g) noexcept
+		: g_{&g} {}
+
+		// Calls visit(node, depth) with every node that src leads to, src itself at depth 0, in
+		// order of depth, and the nodes found from one node in order of value. Stops when visit
+		// returns false, if it returns a bool.
+		template<typename F>
+		auto breadth_first(N const& src, F visit) -> void {
+			auto const source = start(src, "breadth_first");
+			auto const clean = clear_visited{this};
+			auto const& g = *g_;
+			queue_.push_back(source);
+			auto level_end = std::size_t{1};
+			auto depth = std::size_t{0};
+			for (auto i = std::size_t{0}; i < queue_.size(); ++i) {
+				if (i == level_end) {
+					level_end = queue_.size();
+					++depth;
+				}
+				auto const u = static_cast<node_id>(queue_[i]);
+				if (!keep_going(visit, access::value(g, u), depth)) {
+					return;
+				}
+				for (auto const& edge : access::out_edges(g, u)) {
+					if (visited_.set(static_cast<std::size_t>(edge.dst))) {
+						queue_.push_back(static_cast<std::uint32_t>(edge.dst));
+					}
+				}
+			}
+		} // O(log(n) + r log(e) + k), r nodes reached through k edges
+		// Calls visit(node, depth) with every node that src leads to, each before the nodes it
+		// leads to, and the nodes of one src in order of value. depth is the length of the path
+		// that found the node. Stops when visit returns false, if it returns a bool.
+		template<typename F>
+		auto depth_first(N const& src, F visit) -> void {
+			auto const source = start(src, "depth_first");
+			auto const clean = clear_visited{this};
+			auto const& g = *g_;
+			queue_.push_back(source); // every node visited, for clear_visited
+			if (!keep_going(visit, access::value(g, static_cast<node_id>(source)), 0)) {
+				return;
+			}
+			stack_.clear();
+			stack_.push_back(access::out_edges(g, static_cast<node_id>(source)));
+			while (!stack_.empty()) {
+				auto& edges = stack_.back();
+				if (edges.begin() == edges.end()) {
+					stack_.pop_back();
+					continue;
+				}
+				auto const v = edges.begin()->dst;
+				edges = out_edges_range(std::next(edges.begin()), edges.end());
+				if (!visited_.set(static_cast<std::size_t>(v))) {
+					continue;
+				}
+				queue_.push_back(static_cast<std::uint32_t>(v));
+				if (!keep_going(visit, access::value(g, v), stack_.size())) {
+					return;
+				}
+				stack_.push_back(access::out_edges(g, v));
+			}
+		} // O(log(n) + r log(e) + k), r nodes reached through k edges
+		// Returns whether a path of at most max_hops edges leads from src to dst.
+		[[nodiscard]] auto reachable(N const& src,
+		                             N const& dst,
+		                             std::size_t max_hops = std::numeric_limits<std::size_t>::max())
+		   -> bool {
+			auto const count = access::id_count(*g_);
+			auto const target = access::id(*g_, dst);
+			if (access::id(*g_, src) == count or target == count) {
+				throw std::runtime_error("Cannot call gdwg::traversal<N, E>::reachable if src or dst "
+				                         "node don't exist in the graph");
+			}
+			auto const source = start(src, "reachable");
+			auto const clean = clear_visited{this};
+			queue_.push_back(source); // before any return, for clear_visited
+			if (source == target) {
+				return true;
+			}
+			auto level_end = std::size_t{1};
+			// nodes are looked at when they are found, so the last level is never expanded
+			for (auto i = std::size_t{0}, hops = std::size_t{1}; i < queue_.size(); ++i) {
+				if (i == level_end) {
+					level_end = queue_.size();
+					++hops;
+				}
+				if (hops > max_hops) {
+					break;
+				}
+				for (auto const& edge : access::out_edges(*g_, static_cast<node_id>(queue_[i]))) {
+					if (static_cast<std::size_t>(edge.dst) == target) {
+						return true;
+					}
+					if (visited_.set(static_cast<std::size_t>(edge.dst))) {
+						queue_.push_back(static_cast<std::uint32_t>(edge.dst));
+					}
+				}
+			}
+			return false;
+		} // O(log(n) + r log(e) + k), r nodes reached through k edges
+		// Returns every node that src leads to, src included, sorted.
+		[[nodiscard]] auto reachable_from(N const& src) -> std::vector<N> {
+			auto vec = std::vector<N>{};
+			breadth_first(src, [&vec](N const& node, std::size_t) { vec.push_back(node); });
+			std::sort(vec.begin(), vec.end());
+			return vec;
+		} // O(log(n) + r log(e) + k + r log(r))
+
+	private:
+		friend struct detail::parallel_reachable;
+		using access = detail::graph_access;
+		using out_edges_range =
+		   decltype(access::out_edges(std::declval<graph_type const&>(), node_id{}));
+
+		graph_type const* g_;
+		detail::id_bitset visited_{}; // all unset between serial searches
+		detail::id_bitset frontier_{}; // for parallel_traversal.hpp
+		detail::id_bitset next_{};
+		std::vector<std::uint32_t> queue_{}; // every node a serial search has visited
+		std::vector<out_edges_range> stack_{};
+
+		// Unsets the bits of every node the search visited, however it ends.
+		struct clear_visited {
+			traversal* self;
+			explicit clear_visited(traversal* t) noexcept
+			: self{t} {}
+			clear_visited(clear_visited const&) = delete;
+			auto operator=(clear_visited const&) -> clear_visited& = delete;
+			~clear_visited() {
+				for (auto const id : self->queue_) {
+					self->visited_.reset(id);
+				}
+				self->queue_.clear();
+			}
+		};
+
+		// Returns the id of src, marked as visited.
+		auto start(N const& src, char const* function) -> std::uint32_t {
+			auto const source = access::id(*g_, src);
+			if (source == access::id_count(*g_)) {
+				throw std::runtime_error(std::string("Cannot call gdwg::traversal<N, E>::")
+				                         + function + " if src doesn't exist in the graph");
+			}
+			if (visited_.words().size() * detail::id_bitset::word_bits < access::id_count(*g_)) {
+				visited_.assign(access::id_count(*g_));
+			}
+			visited_.set(source);
+			return static_cast<std::uint32_t>(source);
+		}
+		template<typename F>
+		static auto keep_going(F& visit, N const& node, std::size_t depth) -> bool {
+			if constexpr (std::is_same_v<std::invoke_result_t<F&, N const&, std::size_t>, bool>) {
+				return visit(node, depth);
+			}
+			else {
+				visit(node, depth);
+				return true;
+			}
+		}
+	};
+} // namespace gdwg
+
+#endif // GDWG_TRAVERSAL_HPP
@@ -0,0 +1,226 @@
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <memory_resource>
+#include <new>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gdwg/graph.hpp"
+#include "storage_test.hpp"
+#include <concepts/concepts.hpp>
+
+#include <catch2/catch.hpp>
+
+namespace {
+	using tree_graph = gdwg::graph<int, int>;
+	using chunked_graph = gdwg::graph<int, int, gdwg::chunked_storage>;
+	using storage_test::print;
+
+	// Counts the bytes allocated through it.
+	class counting_resource : public std::pmr::memory_resource {
+	public:
+		std::size_t bytes = 0;
+
+	private:
+		auto do_allocate(std::size_t size, std::size_t alignment) -> void* override {
+			bytes += size;
+			return std::pmr::new_delete_resource()->allocate(size, alignment);
+		}
+		auto do_deallocate(void* p, std::size_t size, std::size_t alignment) -> void override {
+			std::pmr::new_delete_resource()->deallocate(p, size, alignment);
+		}
+		[[nodiscard]] auto do_is_equal(std::pmr::memory_resource const& other) const noexcept
+		   -> bool override {
+			return this == &other;
+		}
+	};
+
+	// Throws std::bad_alloc once it has made allowed allocations.
+	class failing_resource : public std::pmr::memory_resource {
+	public:
+		std::size_t allowed = std::numeric_limits<std::size_t>::max();
+
+	private:
+		auto do_allocate(std::size_t size, std::size_t alignment) -> void* override {
+			if (allowed == 0) {
+				throw std::bad_alloc();
+			}
+			--allowed;
+			return std::pmr::new_delete_resource()->allocate(size, alignment);
+		}
+		auto do_deallocate(void* p, std::size_t size, std::size_t alignment) -> void override {
+			std::pmr::new_delete_resource()->deallocate(p, size, alignment);
+		}
+		[[nodiscard]] auto do_is_equal(std::pmr::memory_resource const& other) const noexcept
+		   -> bool override {
+			return this == &other;
+		}
+	};
+} // namespace
+
+TEST_CASE("chunked_storage: graph(I first, S last)") {
+	auto const vt = std::vector<chunked_graph::value_type>{
+	   {2, 3, 4},
+	   {1, 1, 1},
+	   {2, 2, 3},
+	   {1, 2, 2},
+	   {2, 2, 3},
+	};
+	auto const g = chunked_graph(vt.begin(), vt.end());
+	auto const expected_output = std::string_view(R"(1 (
+  1 | 1
+  2 | 2
+)
+2 (
+  2 | 3
+  3 | 4
+)
+3 (
+)
+)");
+	CHECK(print(g) == expected_output);
+	CHECK(print(chunked_graph{3, 1, 2}) == print(tree_graph{3, 1, 2}));
+}
+
+TEST_CASE("chunked_storage: modifiers") {
+	auto g = chunked_graph{1, 2, 3, 4};
+	CHECK(g.insert_edge(3, 1, 1));
+	CHECK(g.insert_edge(1, 3, 1));
+	CHECK(g.insert_edge(1, 2, 2));
+	CHECK(!g.insert_edge(1, 2, 2));
+	CHECK(g.insert_edge(4, 4, 1));
+	auto const snapshot = g;
+	CHECK(g.replace_node(1, 5));
+	CHECK(g.connections(5) == std::vector<int>{2, 3});
+	CHECK(g.connections(3) == std::vector<int>{5});
+	g.merge_replace_node(5, 3);
+	CHECK(g.connections(3) == std::vector<int>{2, 3});
+	CHECK(!g.is_node(5));
+	CHECK(g.erase_edge(3, 3, 1));
+	auto const next = g.erase_edge(g.find(3, 2, 2)); // erasing moves the edges after it
+	CHECK(next == g.find(4, 4, 1));
+	CHECK(g.erase_node(4));
+	CHECK(g.begin() == g.end());
+	CHECK(g.nodes() == std::vector<int>{2, 3});
+	CHECK(snapshot.nodes() == std::vector<int>{1, 2, 3, 4});
+	CHECK(snapshot.connections(1) == std::vector<int>{2, 3});
+	CHECK(snapshot.edge_count() == 4);
+}
+
+// With enough edges to fill many chunks. Snapshots taken on the way must never change.
+TEST_CASE("chunked_storage behaves like tree_storage") {
+	auto const ops = storage_test::random_operations{.nodes = 40,
+	                                                 .weights = 16,
+	                                                 .merge_every = 4,
+	                                                 .erase_every = 12,
+	                                                 .erase_nodes_every = 12,
+	                                                 .batch_dsts = 3,
+	                                                 .erase_stride = 10};
+	auto snapshots = std::vector<std::pair<chunked_graph, std::string>>{};
+	auto const most_edges = storage_test::check_like_tree_storage<gdwg::chunked_storage>(
+	   ops,
+	   [&snapshots](chunked_graph& chunked) {
+		   if (snapshots.size() == 8) {
+			   snapshots.erase(snapshots.begin());
+		   }
+		   snapshots.emplace_back(chunked, print(chunked));
+	   });
+	CHECK(most_edges > 1000); // or the chunks never split
+	for (auto const& [snapshot, printed] : snapshots) {
+		CHECK(print(snapshot) == printed);
+	}
+}
+
+TEST_CASE("chunked_storage: a write after a copy only copies what it touches") {
+	auto resource = counting_resource{};
+	auto edges = std::vector<chunked_graph::value_type>{};
+	for (auto i = 0; i < 20000; ++i) {
+		edges.push_back({i % 2000, (i * 7) % 2000, i % 13});
+	}
+	auto const original = chunked_graph(edges.begin(), edges.end(), &resource);
+	auto const built = resource.bytes;
+	auto copy = chunked_graph(original, &resource);
+	CHECK(copy.insert_edge(1, 2, 100));
+	CHECK(copy.erase_edge(3, 21, 3));
+	CHECK(copy.replace_node(5, 2001));
+	CHECK(resource.bytes - built < built / 10);
+	CHECK(copy.edge_count() == original.edge_count());
+	CHECK(original.is_node(5));
+	CHECK(original.find(1, 2, 100) == original.end());
+	CHECK(original.edge_count() == 20000);
+}
+
+TEST_CASE("chunked_storage: replace_node changes nothing if it runs out of memory") {
+	auto resource = failing_resource{};
+	auto edges = std::vector<chunked_graph::value_type>{};
+	for (auto i = 0; i < 5000; ++i) {
+		edges.push_back({i % 500, (i * 7) % 500, i % 13});
+	}
+	auto const original = chunked_graph(edges.begin(), edges.end(), &resource);
+	auto const expected = print(original);
+	// fails at every allocation in turn, until there are enough for replace_node to finish
+	for (auto allowed = std::size_t{0};; ++allowed) {
+		auto copy = chunked_graph(original, &resource);
+		resource.allowed = allowed;
+		try {
+			CHECK(copy.replace_node(5, 501));
+			resource.allowed = std::numeric_limits<std::size_t>::max();
+			break;
+		} catch (std::bad_alloc const&) {
+			resource.allowed = std::numeric_limits<std::size_t>::max();
+		}
+		REQUIRE(print(copy) == expected);
+		CHECK(copy.fingerprint() == original.fingerprint());
+		CHECK(copy.in_degree(5) == original.in_degree(5));
+	}
+	CHECK(print(original) == expected);
+}
+
+TEST_CASE("chunked_storage: erasing nodes and inserting edges change nothing out of memory") {
+	auto resource = failing_resource{};
+	auto edges = std::vector<chunked_graph::value_type>{};
+	for (auto i = 0; i < 5000; ++i) {
+		edges.push_back({i % 500, (i * 7) % 500, i % 13});
+	}
+	auto const original = chunked_graph(edges.begin(), edges.end(), &resource);
+	auto const expected = print(original);
+	auto const batch = std::vector<chunked_graph::value_type>{{5, 6, 100}, {7, 5, 100}, {5, 35, 5}};
+	auto const victims = std::vector<int>{5, 6, 7};
+	auto const operations = std::vector<std::function<void(chunked_graph&)>>{
+	   [](chunked_graph& g) { CHECK(g.erase_node(5)); },
+	   [&victims](chunked_graph& g) { CHECK(g.erase_nodes(victims.begin(), victims.end()) == 3); },
+	   [&batch](chunked_graph& g) { CHECK(g.insert_edges(batch.begin(), batch.end()) == 2); },
+	};
+	for (auto const& operation : operations) {
+		// fails at every allocation in turn, until there are enough for the operation to finish
+		for (auto allowed = std::size_t{0};; ++allowed) {
+			auto copy = chunked_graph(original, &resource);
+			resource.allowed = allowed;
+			try {
+				operation(copy);
+				resource.allowed = std::numeric_limits<std::size_t>::max();
+				break;
+			} catch (std::bad_alloc const&) {
+				resource.allowed = std::numeric_limits<std::size_t>::max();
+			}
+			REQUIRE(print(copy) == expected);
+			CHECK(copy.fingerprint() == original.fingerprint());
+			CHECK(copy.out_degree(5) == original.out_degree(5));
+			CHECK(copy.in_degree(6) == original.in_degree(6));
+		}
+	}
+	CHECK(print(original) == expected);
+}
+
+TEST_CASE("chunked_storage: Iterator Type Test") {
+	static_assert(ranges::bidirectional_iterator<chunked_graph::iterator>);
+	auto const vt = std::vector<chunked_graph::value_type>{{1, 2, 1}, {2, 1, 1}};
+	auto const g = chunked_graph(vt.begin(), vt.end());
+	auto iter = g.end();
+	--iter;
+	CHECK(std::get<0>(*iter) == 2);
+	CHECK(std::prev(iter) == g.begin());
+}
@@ -0,0 +1,126 @@
+#include <atomic>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gdwg/concurrent_graph.hpp"
+#include "gdwg/graph.hpp"
+
+#include <catch2/catch.hpp>
+
+namespace {
+	using graph = gdwg::graph<int, int, gdwg::chunked_storage>;
+	using concurrent_graph = gdwg::concurrent_graph<int, int>;
+} // namespace
+
+TEST_CASE("concurrent_graph has the API of graph") {
+	auto const vt = std::vector<graph::value_type>{{1, 2, 1}, {2, 3, 2}, {1, 2, 3}};
+	auto g = concurrent_graph(vt.begin(), vt.end());
+	auto const reference = graph(vt.begin(), vt.end());
+	CHECK(g.snapshot() == reference);
+	CHECK(g.is_node(1));
+	CHECK(!g.is_node(4));
+	CHECK(!g.empty());
+	CHECK(g.fingerprint() == reference.fingerprint());
+	CHECK(g.is_connected(1, 2));
+	CHECK(g.nodes() == std::vector<int>{1, 2, 3});
+	CHECK(g.weights(1, 2) == std::vector<int>{1, 3});
+	CHECK(g.connections(1) == std::vector<int>{2});
+	CHECK(g.predecessors(2) == std::vector<int>{1});
+	CHECK(g.in_degree(2) == 2);
+	CHECK(g.out_degree(1) == 2);
+	CHECK(g.node_count() == 3);
+	CHECK(g.edge_count() == 3);
+	CHECK(g.in_edges(3).size() == 1);
+	auto const found = g.find(2, 3, 2);
+	REQUIRE(found.has_value());
+	CHECK(found->from == 2);
+	CHECK(found->to == 3);
+	CHECK(found->weight == 2);
+	CHECK(!g.find(2, 3, 1).has_value());
+	CHECK_THROWS_WITH(g.is_connected(1, 4),
+	                  "Cannot call gdwg::graph<N, E>::is_connected if src or dst node don't "
+	                  "exist in the graph");
+
+	CHECK(g.insert_node(4));
+	CHECK(g.insert_edge(4, 1, 5));
+	CHECK(g.replace_node(4, 5));
+	g.merge_replace_node(5, 3);
+	CHECK(g.connections(3) == std::vector<int>{1});
+	CHECK(g.erase_edge(3, 1, 5));
+	CHECK(g.erase_node(3));
+	auto const batch = std::vector<graph::value_type>{{2, 2, 1}, {2, 1, 1}};
+	CHECK(g.insert_edges(batch.begin(), batch.end()) == 2);
+	CHECK(g.erase_edges(batch.begin(), batch.begin() + 1) == 1);
+	auto const victims = std::vector<int>{1};
+	CHECK(g.erase_nodes(victims.begin(), victims.end()) == 1);
+	CHECK(g.update([](graph& h) { return h.insert_node(6) and h.insert_edge(6, 2, 1); }));
+	auto out = std::ostringstream{};
+	out << g;
+	CHECK(out.str() == "2 (\n)\n6 (\n  2 | 1\n)\n");
+	g.clear();
+	CHECK(g.empty());
+	CHECK(g == concurrent_graph{});
+}
+
+TEST_CASE("concurrent_graph snapshots don't see later writes") {
+	auto g = concurrent_graph{1, 2};
+	auto const before = g.snapshot();
+	CHECK(g.insert_edge(1, 2, 1));
+	CHECK(!before.is_connected(1, 2));
+	CHECK(g.snapshot().is_connected(1, 2));
+}
+
+// Writers insert and erase pairs of edges in single batches, so a reader must always see both
+// edges of a pair or neither.
+TEST_CASE("concurrent_graph readers never see half a batch") {
+	constexpr auto pairs = 200;
+	auto nodes = std::vector<int>{};
+	for (auto i = 0; i < 2 * pairs; ++i) {
+		nodes.push_back(i);
+	}
+	auto g = concurrent_graph(nodes.begin(), nodes.end());
+	auto done = std::atomic<bool>{false};
+	auto torn = std::atomic<int>{0};
+	auto readers = std::vector<std::thread>{};
+	for (auto r = 0; r < 4; ++r) {
+		readers.emplace_back([&g, &done, &torn, r] {
+			for (auto i = r; !done.load(); i = (i + 1) % pairs) {
+				static_cast<void>(g.weights(2 * i, 2 * i + 1)); // reads alongside the writers
+				auto const snapshot = g.snapshot();
+				auto const forward = snapshot.is_connected(2 * i, 2 * i + 1);
+				if (forward != snapshot.is_connected(2 * i + 1, 2 * i)) {
+					++torn;
+				}
+			}
+		});
+	}
+	auto writers = std::vector<std::thread>{};
+	for (auto w = 0; w < 2; ++w) {
+		writers.emplace_back([&g, w] {
+			for (auto round = 0; round < 20; ++round) {
+				for (auto i = w; i < pairs; i += 2) {
+					auto const batch =
+					   std::vector<graph::value_type>{{2 * i, 2 * i + 1, 0}, {2 * i + 1, 2 * i, 0}};
+					if (round % 2 == 0) {
+						g.insert_edges(batch.begin(), batch.end());
+					}
+					else {
+						g.erase_edges(batch.begin(), batch.end());
+					}
+				}
+			}
+		});
+	}
+	for (auto& i : writers) {
+		i.join();
+	}
+	done = true;
+	for (auto& i : readers) {
+		i.join();
+	}
+	CHECK(torn == 0);
+	auto const last = g.snapshot();
+	CHECK(last.begin() == last.end()); // every pair was erased again
+}
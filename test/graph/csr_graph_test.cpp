@@ -0,0 +1,102 @@
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "gdwg/csr_graph.hpp"
+#include "gdwg/graph.hpp"
+#include <concepts/concepts.hpp>
+
+#include <catch2/catch.hpp>
+
+namespace {
+	using graph = gdwg::graph<std::string, int>;
+	using csr_graph = gdwg::csr_graph<std::string, int>;
+
+	auto make_graph() -> graph {
+		auto const vt = std::vector<graph::value_type>{
+		   {"B", "A", 1},
+		   {"B", "C", 3},
+		   {"B", "C", 2},
+		   {"B", "B", 4},
+		   {"D", "A", 5},
+		};
+		auto g = graph(vt.begin(), vt.end());
+		g.insert_node("0"); // sorts before every node with edges
+		g.insert_node("E"); // sorts after them
+		g.insert_node("C0"); // sits between two nodes with edges
+		return g;
+	}
+} // namespace
+
+TEST_CASE("csr_graph(graph const& g)") {
+	auto const g = make_graph();
+	auto const csr = csr_graph(g);
+	CHECK(csr.nodes() == g.nodes());
+	auto iter = g.begin();
+	for (auto const& [from, to, weight] : csr) {
+		REQUIRE(iter != g.end());
+		auto const& [g_from, g_to, g_weight] = *iter;
+		CHECK(from == g_from);
+		CHECK(to == g_to);
+		CHECK(weight == g_weight);
+		++iter;
+	}
+	CHECK(iter == g.end());
+	CHECK(std::distance(csr.begin(), csr.end()) == 5);
+}
+
+TEST_CASE("csr_graph of an empty graph") {
+	auto const csr = csr_graph(graph{});
+	CHECK(csr.empty());
+	CHECK(csr.begin() == csr.end());
+	CHECK(!csr.is_node("A"));
+	CHECK(csr_graph{}.begin() == csr_graph{}.end());
+	auto const nodes_only = csr_graph(graph{"A", "B"});
+	CHECK(!nodes_only.empty());
+	CHECK(nodes_only.begin() == nodes_only.end());
+	CHECK(nodes_only.connections("A").empty());
+}
+
+TEST_CASE("csr_graph accessors agree with graph") {
+	auto const g = make_graph();
+	auto const csr = csr_graph(g);
+	for (auto const& src : g.nodes()) {
+		CHECK(csr.is_node(src));
+		CHECK(csr.connections(src) == g.connections(src));
+		for (auto const& dst : g.nodes()) {
+			CHECK(csr.is_connected(src, dst) == g.is_connected(src, dst));
+			CHECK(csr.weights(src, dst) == g.weights(src, dst));
+		}
+	}
+	CHECK(!csr.is_node("F"));
+	CHECK_THROWS_WITH(csr.is_connected("B", "F"),
+	                  "Cannot call gdwg::csr_graph<N, E>::is_connected if src or dst node don't "
+	                  "exist in the graph");
+	CHECK_THROWS_WITH(csr.weights("F", "B"),
+	                  "Cannot call gdwg::csr_graph<N, E>::weights if src or dst node don't exist in "
+	                  "the graph");
+	CHECK_THROWS_WITH(csr.connections("F"),
+	                  "Cannot call gdwg::csr_graph<N, E>::connections if src doesn't exist in the "
+	                  "graph");
+}
+
+TEST_CASE("csr_graph find") {
+	auto const csr = csr_graph(make_graph());
+	auto const iter = csr.find("B", "C", 3);
+	REQUIRE(iter != csr.end());
+	auto const& [from, to, weight] = *iter;
+	CHECK(from == "B");
+	CHECK(to == "C");
+	CHECK(weight == 3);
+	CHECK(std::next(iter) != csr.end());
+	CHECK(std::get<0>(*std::next(iter)) == "D");
+	CHECK(std::get<2>(*std::prev(iter)) == 2);
+	CHECK(csr.find("B", "C", 5) == csr.end());
+	CHECK(csr.find("C", "B", 3) == csr.end());
+	CHECK(csr.find("F", "C", 3) == csr.end());
+	CHECK(std::get<0>(*std::prev(csr.end())) == "D");
+}
+
+TEST_CASE("csr_graph Iterator Type Test") {
+	static_assert(ranges::bidirectional_iterator<csr_graph::iterator>);
+}
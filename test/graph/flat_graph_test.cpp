@@ -0,0 +1,91 @@
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "gdwg/graph.hpp"
+#include "storage_test.hpp"
+#include <concepts/concepts.hpp>
+
+#include <catch2/catch.hpp>
+
+namespace {
+	using tree_graph = gdwg::graph<int, int>;
+	using flat_graph = gdwg::graph<int, int, gdwg::flat_storage>;
+	using storage_test::print;
+} // namespace
+
+TEST_CASE("flat_storage: graph(I first, S last)") {
+	auto const vt = std::vector<flat_graph::value_type>{
+	   {2, 3, 4},
+	   {1, 1, 1},
+	   {2, 2, 3},
+	   {1, 2, 2},
+	   {2, 2, 3},
+	};
+	auto const g = flat_graph(vt.begin(), vt.end());
+	auto const expected_output = std::string_view(R"(1 (
+  1 | 1
+  2 | 2
+)
+2 (
+  2 | 3
+  3 | 4
+)
+3 (
+)
+)");
+	CHECK(print(g) == expected_output);
+	CHECK(print(flat_graph{3, 1, 2}) == print(tree_graph{3, 1, 2}));
+}
+
+TEST_CASE("flat_storage: modifiers") {
+	auto g = flat_graph{1, 2, 3, 4};
+	CHECK(g.insert_edge(3, 1, 1));
+	CHECK(g.insert_edge(1, 3, 1));
+	CHECK(g.insert_edge(1, 2, 2));
+	CHECK(!g.insert_edge(1, 2, 2));
+	CHECK(g.insert_edge(4, 4, 1));
+	CHECK(g.replace_node(1, 5));
+	CHECK(g.connections(5) == std::vector<int>{2, 3});
+	CHECK(g.connections(3) == std::vector<int>{5});
+	g.merge_replace_node(5, 3);
+	CHECK(g.connections(3) == std::vector<int>{2, 3});
+	CHECK(!g.is_node(5));
+	CHECK(g.erase_edge(3, 3, 1));
+	CHECK(g.erase_edge(g.find(3, 2, 2)) == g.find(4, 4, 1));
+	CHECK(g.erase_node(4));
+	CHECK(g.begin() == g.end());
+	CHECK(g.nodes() == std::vector<int>{2, 3});
+	auto const batch = std::vector<flat_graph::value_type>{{3, 2, 1}, {2, 3, 1}, {3, 2, 1}};
+	CHECK(g.insert_edges(batch.begin(), batch.end()) == 2);
+	CHECK(g.erase_edges(batch.begin(), batch.end()) == 2);
+	CHECK(g.insert_edges(batch.begin(), batch.end()) == 2);
+	auto const victims = std::vector<int>{2};
+	CHECK(g.erase_nodes(victims.begin(), victims.end()) == 1);
+	CHECK(g.begin() == g.end());
+}
+
+// A copy of a flat graph is a flat graph too.
+TEST_CASE("flat_storage behaves like tree_storage") {
+	auto const ops = storage_test::random_operations{.nodes = 25,
+	                                                 .weights = 3,
+	                                                 .merge_every = 1,
+	                                                 .erase_every = 4,
+	                                                 .erase_nodes_every = 3,
+	                                                 .batch_dsts = 1,
+	                                                 .erase_stride = 3};
+	storage_test::check_like_tree_storage<gdwg::flat_storage>(ops, [](flat_graph& flat) {
+		auto const copy = flat;
+		flat = copy;
+	});
+}
+
+TEST_CASE("flat_storage: Iterator Type Test") {
+	static_assert(ranges::bidirectional_iterator<flat_graph::iterator>);
+	auto const vt = std::vector<flat_graph::value_type>{{1, 2, 1}, {2, 1, 1}};
+	auto const g = flat_graph(vt.begin(), vt.end());
+	auto iter = g.end();
+	--iter;
+	CHECK(std::get<0>(*iter) == 2);
+	CHECK(std::prev(iter) == g.begin());
+}
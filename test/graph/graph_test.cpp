@@ -1,10 +1,19 @@
+#include <algorithm>
+#include <functional>
 #include <iostream>
 #include <iterator>
+#include <memory_resource>
+#include <ranges>
 #include <string>
+#include <tuple>
+#include <type_traits>
+#include <unordered_set>
 #include <vector>
 
 #include "gdwg/graph.hpp"
 #include <concepts/concepts.hpp>
+#include <range/v3/view/filter.hpp>
+#include <range/v3/view/transform.hpp>
 
 #include <catch2/catch.hpp>
 #include <fmt/format.h>
@@ -70,6 +79,38 @@ TEST_CASE("value_type: graph(I first, S last)") {
 	CHECK(out.str() == expected_output);
 }
 
+TEST_CASE("value_type: graph(I first, S last) with input iterators and duplicates") {
+	using graph = gdwg::graph<int, int>;
+	auto in = std::istringstream("3 1 2 1 3 2");
+	auto edges = std::views::istream<int>(in) | std::views::transform([](int i) {
+		             return graph::value_type{i % 2, i, 1}; // 3 and 1 appear twice
+	             });
+	static_assert(!std::forward_iterator<decltype(edges.begin())>);
+	auto h = graph(edges.begin(), edges.end());
+	auto out = std::ostringstream{};
+	out << h;
+	auto const expected_output = std::string_view(R"(0 (
+  2 | 1
+)
+1 (
+  1 | 1
+  3 | 1
+)
+2 (
+)
+3 (
+)
+)");
+	CHECK(out.str() == expected_output);
+	CHECK(h.is_connected(0, 2));
+	CHECK(h.connections(1) == std::vector<int>{1, 3});
+	auto empty_in = std::istringstream("");
+	auto no_edges = std::views::istream<int>(empty_in) | std::views::transform([](int i) {
+		                return graph::value_type{i, i, i};
+	                });
+	CHECK(graph(no_edges.begin(), no_edges.end()).empty());
+}
+
 TEST_CASE("graph(graph&& other) noexcept") {
 	using graph = gdwg::graph<int, int>;
 	auto const vt = std::vector<graph::value_type>{
@@ -152,6 +193,120 @@ TEST_CASE("auto operator=(graph const& other) -> graph&") {
 	CHECK(!h.is_node(5));
 }
 
+namespace {
+	// Counts what a graph allocates, and fails the test if it leaks.
+	class counting_resource : public std::pmr::memory_resource {
+	public:
+		std::size_t allocations = 0;
+		std::size_t outstanding = 0;
+
+	private:
+		auto do_allocate(std::size_t bytes, std::size_t alignment) -> void* override {
+			++allocations;
+			outstanding += bytes;
+			return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+		}
+		auto do_deallocate(void* p, std::size_t bytes, std::size_t alignment) -> void override {
+			outstanding -= bytes;
+			std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+		}
+		[[nodiscard]] auto do_is_equal(std::pmr::memory_resource const& other) const noexcept
+		   -> bool override {
+			return this == &other;
+		}
+	};
+
+	// Makes every allocation from the default resource throw while it is alive.
+	struct no_default_resource {
+		std::pmr::memory_resource* previous =
+		   std::pmr::set_default_resource(std::pmr::null_memory_resource());
+		no_default_resource() = default;
+		no_default_resource(no_default_resource const&) = delete;
+		auto operator=(no_default_resource const&) -> no_default_resource& = delete;
+		~no_default_resource() {
+			std::pmr::set_default_resource(previous);
+		}
+	};
+} // namespace
+
+TEST_CASE("graph(std::pmr::memory_resource* resource)") {
+	using graph = gdwg::graph<std::pmr::string, int>;
+	auto resource = counting_resource{};
+	auto const long_name = std::pmr::string("a node name too long for the small string buffer");
+	{
+		auto const guard = no_default_resource{};
+		auto g = graph(&resource);
+		CHECK(g.resource() == &resource);
+		CHECK(g.insert_node(long_name)); // the copy in the graph uses the graph's resource
+		CHECK(g.insert_node("B"));
+		CHECK(g.insert_edge("B", "B", 1));
+		CHECK(g.replace_node("B", "C"));
+		CHECK(resource.allocations > 0);
+		auto const vt = std::vector<graph::value_type>{{"A", "B", 1}, {"B", "C", 2}};
+		auto const h = graph(vt.begin(), vt.end(), &resource);
+		auto const copy = graph(h, &resource);
+		CHECK(copy == h);
+		auto moved = std::move(g);
+		CHECK(moved.resource() == &resource);
+		moved = graph(&resource);
+		CHECK(moved.empty());
+	}
+	CHECK(resource.outstanding == 0);
+	auto const g = graph({"A"}, &resource);
+	CHECK(graph(g).resource() == std::pmr::get_default_resource());
+	CHECK(graph(g).is_node("A"));
+}
+
+TEST_CASE("copies are snapshots that share storage until either graph is modified") {
+	using graph = gdwg::graph<int, int>;
+	auto resource = counting_resource{};
+	auto const vt = std::vector<graph::value_type>{
+	   {1, 1, 1},
+	   {1, 2, 2},
+	   {2, 2, 3},
+	   {2, 3, 4},
+	};
+	auto g = graph(vt.begin(), vt.end(), &resource);
+	auto const allocations = resource.allocations;
+	auto const snapshot = graph(g, &resource);
+	auto copy = graph(&resource);
+	copy = g;
+	CHECK(resource.allocations == allocations); // nothing is copied yet
+	CHECK(snapshot == g);
+	auto out = std::ostringstream{};
+	out << snapshot;
+	auto const before = out.str();
+
+	// every modifier copies before it writes, and leaves the snapshot as it was
+	CHECK(g.insert_edge(3, 1, 5));
+	CHECK(resource.allocations > allocations);
+	CHECK(!snapshot.is_connected(3, 1));
+	CHECK(copy.erase_node(1));
+	CHECK(copy.is_node(2));
+	CHECK(!copy.is_node(1));
+	auto nodes_only = snapshot;
+	nodes_only.clear();
+	CHECK(nodes_only.empty());
+	auto batch = snapshot;
+	auto const victims = std::vector<int>{2, 3};
+	CHECK(batch.erase_nodes(victims.begin(), victims.end()) == 2);
+	CHECK(batch.erase_edges(vt.begin(), vt.begin() + 1) == 1);
+	CHECK(batch.nodes() == std::vector<int>{1});
+	out.str("");
+	out << snapshot;
+	CHECK(out.str() == before);
+
+	// iterators of a shared graph still name their edge once it has been copied
+	auto h = snapshot;
+	auto const iter = h.erase_edge(h.find(1, 2, 2));
+	CHECK(iter == h.find(2, 2, 3));
+	CHECK(h.erase_edge(h.begin(), h.find(2, 3, 4)) == h.find(2, 3, 4));
+	CHECK(std::distance(h.begin(), h.end()) == 1);
+	auto k = snapshot;
+	CHECK(k.erase_edge(k.find(2, 3, 4)) == k.end());
+	CHECK(std::distance(snapshot.begin(), snapshot.end()) == 4);
+}
+
 TEST_CASE("insert_node") {
 	auto g = gdwg::graph<int, std::string>{2, 3, 4};
 	CHECK(g.insert_node(5));
@@ -235,6 +390,39 @@ TEST_CASE("replace_node") {
 	out2 << g;
 	CHECK(out1.str() == out2.str());
 }
+TEST_CASE("replace_node moves the node's edges to their new place") {
+	using graph = gdwg::graph<std::string, int>;
+	auto const vt1 = std::vector<graph::value_type>{
+	   {"A", "B", 1},
+	   {"A", "A", 2},
+	   {"B", "A", 3},
+	   {"C", "A", 4},
+	   {"C", "D", 5},
+	};
+	auto h = graph(vt1.begin(), vt1.end());
+	CHECK(h.replace_node("A", "E"));
+	auto const vt2 = std::vector<graph::value_type>{
+	   {"B", "E", 3},
+	   {"C", "D", 5},
+	   {"C", "E", 4},
+	   {"E", "B", 1},
+	   {"E", "E", 2},
+	};
+	auto const g = graph(vt2.begin(), vt2.end());
+	auto out1 = std::ostringstream{};
+	out1 << h;
+	auto out2 = std::ostringstream{};
+	out2 << g;
+	CHECK(out1.str() == out2.str());
+	CHECK(std::equal(h.begin(), h.end(), g.begin(), g.end()));
+	CHECK(h.connections("C") == std::vector<std::string>{"D", "E"});
+	CHECK(h.find("E", "E", 2) != h.end());
+	// the incoming edges were moved too
+	CHECK(h.erase_node("E"));
+	CHECK(h.connections("B").empty());
+	CHECK(h.connections("C") == std::vector<std::string>{"D"});
+}
+
 TEST_CASE("merge_replace_node") {
 	using graph = gdwg::graph<std::string, int>;
 	auto const vt1 = std::vector<graph::value_type>{
@@ -294,6 +482,56 @@ TEST_CASE("erase_node") {
 	CHECK(out1.str() == out2.str());
 }
 
+TEST_CASE("erase_node and merge_replace_node keep incoming edges in sync") {
+	using graph = gdwg::graph<std::string, int>;
+	auto const vt1 = std::vector<graph::value_type>{
+	   {"A", "B", 1},
+	   {"A", "C", 2},
+	   {"A", "D", 3},
+	   {"B", "B", 1},
+	   {"C", "A", 4},
+	   {"D", "A", 5},
+	};
+	auto h = graph(vt1.begin(), vt1.end());
+	h.merge_replace_node("A", "B");
+	auto out1 = std::ostringstream{};
+	out1 << h;
+	auto const vt2 = std::vector<graph::value_type>{
+	   {"B", "B", 1},
+	   {"B", "C", 2},
+	   {"B", "D", 3},
+	   {"C", "B", 4},
+	   {"D", "B", 5},
+	};
+	auto g = graph(vt2.begin(), vt2.end());
+	auto out2 = std::ostringstream{};
+	out2 << g;
+	CHECK(out1.str() == out2.str());
+	CHECK(h.erase_node("B"));
+	CHECK(h.begin() == h.end());
+	CHECK(h.nodes() == std::vector<std::string>{"C", "D"});
+}
+
+TEST_CASE("erased nodes free their slot for the next insert_node") {
+	using graph = gdwg::graph<std::string, int>;
+	auto const vt = std::vector<graph::value_type>{
+	   {"A", "C", 1},
+	   {"C", "E", 2},
+	};
+	auto g = graph(vt.begin(), vt.end());
+	CHECK(g.erase_node("A"));
+	CHECK(g.insert_node("F")); // takes the slot "A" had, but must still sort after "E"
+	CHECK(g.insert_node("B"));
+	CHECK(g.insert_edge("F", "B", 3));
+	CHECK(g.nodes() == std::vector<std::string>{"B", "C", "E", "F"});
+	CHECK(g.connections("F") == std::vector<std::string>{"B"});
+	CHECK(!g.is_node("A"));
+	auto h = graph{"X"};
+	h = g; // copy assignment replaces the contents of h
+	CHECK(h == g);
+	CHECK(!h.is_node("X"));
+}
+
 TEST_CASE("erase_edge(N, N, E)") {
 	using graph = gdwg::graph<int, int>;
 	auto const vt1 = std::vector<graph::value_type>{
@@ -384,6 +622,120 @@ TEST_CASE("erase_edge(iter,iter)") {
 	CHECK(h.erase_edge(h.find(2, 4, 1), h.end()) == h.end());
 	CHECK(h.find(1, 1, 1) != h.end());
 }
+TEST_CASE("insert_edges") {
+	using graph = gdwg::graph<int, int>;
+	auto const vt1 = std::vector<graph::value_type>{
+	   {1, 2, 1},
+	   {2, 3, 1},
+	};
+	auto h = graph(vt1.begin(), vt1.end());
+	h.insert_node(4);
+	auto const bad = std::vector<graph::value_type>{
+	   {1, 1, 1},
+	   {4, 5, 1},
+	};
+	CHECK_THROWS_MATCHES(h.insert_edges(bad.begin(), bad.end()),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot call gdwg::graph<N, E>::insert_edges when "
+	                                              "either src or dst node does not exist"));
+	CHECK(!h.is_connected(1, 1)); // a batch that throws inserts nothing
+	auto const batch = std::vector<graph::value_type>{
+	   {4, 1, 2},
+	   {1, 2, 1}, // already in the graph
+	   {1, 1, 1},
+	   {4, 1, 2}, // twice in the batch
+	   {1, 2, 3},
+	   {3, 4, 1},
+	};
+	CHECK(h.insert_edges(batch.begin(), batch.end()) == 4);
+	CHECK(h.insert_edges(batch.begin(), batch.begin()) == 0);
+	auto const vt2 = std::vector<graph::value_type>{
+	   {1, 1, 1},
+	   {1, 2, 1},
+	   {1, 2, 3},
+	   {2, 3, 1},
+	   {3, 4, 1},
+	   {4, 1, 2},
+	};
+	CHECK(h == graph(vt2.begin(), vt2.end()));
+	// the incoming edges were indexed too
+	CHECK(h.erase_node(1));
+	CHECK(h.connections(4).empty());
+}
+
+TEST_CASE("erase_edges") {
+	using graph = gdwg::graph<int, int>;
+	auto const vt1 = std::vector<graph::value_type>{
+	   {1, 1, 1},
+	   {1, 2, 1},
+	   {2, 2, 1},
+	   {2, 3, 1},
+	};
+	auto h = graph(vt1.begin(), vt1.end());
+	auto const bad = std::vector<graph::value_type>{
+	   {1, 1, 1},
+	   {5, 1, 1},
+	};
+	CHECK_THROWS_MATCHES(h.erase_edges(bad.begin(), bad.end()),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot call comp6771::graph<N, E>::erase_edges "
+	                                              "on src or dst if they don't exist in the graph"));
+	CHECK(h.is_connected(1, 1)); // a batch that throws erases nothing
+	auto const batch = std::vector<graph::value_type>{
+	   {2, 3, 1},
+	   {1, 1, 1},
+	   {1, 1, 2}, // not in the graph
+	   {2, 3, 1}, // twice in the batch
+	};
+	CHECK(h.erase_edges(batch.begin(), batch.end()) == 2);
+	auto const vt2 = std::vector<graph::value_type>{
+	   {1, 2, 1},
+	   {2, 2, 1},
+	};
+	auto g = graph(vt2.begin(), vt2.end());
+	g.insert_node(3);
+	CHECK(h == g);
+	CHECK(h.erase_node(2));
+	CHECK(h.begin() == h.end());
+}
+
+TEST_CASE("erase_nodes") {
+	using graph = gdwg::graph<int, int>;
+	auto vt = std::vector<graph::value_type>{};
+	for (auto i = 0; i < 8; ++i) {
+		for (auto j = 0; j < 8; ++j) {
+			vt.push_back({i, j, i * j});
+		}
+	}
+	vt.push_back({8, 0, 1});
+	vt.push_back({9, 9, 1});
+	auto h = graph(vt.begin(), vt.end());
+	auto g = h;
+	auto const empty = std::vector<int>{};
+	CHECK(h.erase_nodes(empty.begin(), empty.end()) == 0);
+	// a few edges: they are found through each node
+	auto const few = std::vector<int>{8, 10, 8};
+	CHECK(h.erase_nodes(few.begin(), few.end()) == 1);
+	CHECK(!h.is_node(8));
+	CHECK(h.weights(1, 0) == std::vector<int>{0});
+	CHECK(h.connections(9) == std::vector<int>{9});
+	// most of the edges: the edges are swept once
+	auto const many = std::vector<int>{0, 1, 2, 3, 4, 5, 9};
+	CHECK(h.erase_nodes(many.begin(), many.end()) == 7);
+	CHECK(h.nodes() == std::vector<int>{6, 7});
+	CHECK(h.connections(6) == std::vector<int>{6, 7});
+	CHECK(h.connections(7) == std::vector<int>{6, 7});
+	CHECK(std::distance(h.begin(), h.end()) == 4);
+	// both ways leave the same graph as erase_node
+	for (auto const node : {8, 0, 1, 2, 3, 4, 5, 9}) {
+		CHECK(g.erase_node(node));
+	}
+	CHECK(h == g);
+	CHECK(h.erase_node(6));
+	CHECK(h.weights(7, 7) == std::vector<int>{49});
+	CHECK(h.connections(7) == std::vector<int>{7});
+}
+
 TEST_CASE("clear") {
 	using graph = gdwg::graph<int, int>;
 	auto const vt1 = std::vector<graph::value_type>{
@@ -516,6 +868,213 @@ TEST_CASE("connections") {
 	                                              "src doesn't exist in the graph"));
 	CHECK(h.connections(2) == std::vector<int>{2, 3, 4, 5});
 	CHECK(h.connections(10).empty());
+	CHECK(gdwg::graph<int, int>{1, 2}.connections(1).empty());
+}
+TEST_CASE("connections_view") {
+	using graph = gdwg::graph<int, int>;
+	auto const vt1 = std::vector<graph::value_type>{
+	   {1, 1, 1},
+	   {2, 2, 1},
+	   {2, 3, 5},
+	   {2, 3, 3},
+	   {2, 5, 1},
+	   {3, 5, 5},
+	};
+	auto h = graph(vt1.begin(), vt1.end());
+	h.insert_node(10);
+	CHECK_THROWS_MATCHES(h.connections_view(6),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot call gdwg::graph<N, E>::connections_view "
+	                                              "if src doesn't exist in the graph"));
+	auto const view = h.connections_view(2);
+	CHECK(std::vector<int>(view.begin(), view.end()) == std::vector<int>{2, 3, 5});
+	CHECK(&*view.begin() == &*h.connections_view(2).begin());
+	CHECK(h.connections_view(10).empty());
+	CHECK(h.connections_view(5).begin() == h.connections_view(5).end());
+	static_assert(ranges::forward_iterator<decltype(view.begin())>);
+}
+TEST_CASE("predecessors, in_degree and in_edges") {
+	using graph = gdwg::graph<int, int>;
+	auto const vt1 = std::vector<graph::value_type>{
+	   {1, 3, 1},
+	   {2, 2, 1},
+	   {2, 3, 5},
+	   {2, 3, 3},
+	   {5, 3, 1},
+	   {3, 5, 5},
+	};
+	auto h = graph(vt1.begin(), vt1.end());
+	h.insert_node(10);
+	CHECK(h.predecessors(3) == std::vector<int>{1, 2, 5});
+	CHECK(h.predecessors(2) == std::vector<int>{2});
+	CHECK(h.predecessors(1).empty());
+	CHECK(h.predecessors(10).empty());
+	CHECK(h.in_degree(3) == 4);
+	CHECK(h.in_degree(1) == 0);
+	auto const in = h.in_edges(3);
+	using edge_list = std::vector<std::tuple<int, int, int>>;
+	auto edges = edge_list{};
+	for (auto const& [from, to, weight] : in) {
+		edges.emplace_back(from, to, weight);
+	}
+	CHECK(edges == edge_list{{1, 3, 1}, {2, 3, 3}, {2, 3, 5}, {5, 3, 1}});
+	// the reverse index follows every change
+	h.erase_node(2);
+	h.replace_node(5, 4);
+	h.insert_edge(10, 3, 7);
+	CHECK(h.predecessors(3) == std::vector<int>{1, 4, 10});
+	CHECK(h.in_degree(3) == 3);
+	h.merge_replace_node(4, 1); // 4 -> 3 merges into 1 -> 3
+	CHECK(h.predecessors(3) == std::vector<int>{1, 10});
+	CHECK(h.in_degree(3) == 2);
+	CHECK(h.predecessors(1) == std::vector<int>{3});
+	CHECK_THROWS_MATCHES(h.predecessors(2),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot call gdwg::graph<N, E>::predecessors if "
+	                                              "dst doesn't exist in the graph"));
+	CHECK_THROWS_MATCHES(h.in_degree(2),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot call gdwg::graph<N, E>::in_degree if dst "
+	                                              "doesn't exist in the graph"));
+	CHECK_THROWS_MATCHES(h.in_edges(2),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot call gdwg::graph<N, E>::in_edges if dst "
+	                                              "doesn't exist in the graph"));
+}
+TEST_CASE("node_count, edge_count and out_degree") {
+	using graph = gdwg::graph<int, int>;
+	auto const vt1 = std::vector<graph::value_type>{
+	   {1, 3, 1},
+	   {2, 2, 1},
+	   {2, 3, 5},
+	   {2, 3, 3},
+	   {2, 3, 3}, // a duplicate, counted once
+	   {5, 3, 1},
+	   {3, 5, 5},
+	};
+	auto h = graph(vt1.begin(), vt1.end());
+	h.insert_node(10);
+	CHECK(h.node_count() == 5);
+	CHECK(h.edge_count() == 6);
+	CHECK(h.out_degree(2) == 3);
+	CHECK(h.in_degree(2) == 1);
+	CHECK(h.out_degree(10) == 0);
+	CHECK(graph{}.node_count() == 0);
+	CHECK(graph{}.edge_count() == 0);
+
+	auto const snapshot = h;
+	h.erase_node(2); // with a reflexive edge
+	CHECK(h.node_count() == 4);
+	CHECK(h.edge_count() == 3);
+	CHECK(h.in_degree(3) == 2);
+	CHECK(snapshot.out_degree(2) == 3); // a copy is not written through
+	CHECK(snapshot.in_degree(3) == 4);
+	h.insert_node(2); // reuses the id of the erased node
+	CHECK(h.out_degree(2) == 0);
+	CHECK(h.in_degree(2) == 0);
+	h.insert_edge(10, 1, 2);
+	h.insert_edge(10, 5, 1);
+	h.replace_node(10, 4);
+	CHECK(h.out_degree(4) == 2);
+	h.merge_replace_node(5, 1); // 5 -> 3 1 merges into 1 -> 3 1
+	CHECK(h.edge_count() == 4);
+	CHECK(h.out_degree(1) == 1);
+	CHECK(h.in_degree(1) == 3);
+	CHECK(h.out_degree(3) == 1);
+	CHECK(h.in_degree(3) == 1);
+	h.erase_edge(4, 1, 1);
+	h.erase_edge(h.begin());
+	CHECK(h.edge_count() == 2);
+	CHECK(h.in_degree(1) == 2);
+	CHECK(h.in_degree(3) == 0);
+	auto const batch = std::vector<graph::value_type>{{2, 4, 1}, {2, 4, 2}, {4, 4, 1}};
+	h.insert_edges(batch.begin(), batch.end());
+	CHECK(h.out_degree(2) == 2);
+	CHECK(h.in_degree(4) == 3);
+	h.erase_edges(batch.begin(), batch.begin() + 1);
+	CHECK(h.in_degree(4) == 2);
+	auto const victims = std::vector<int>{4};
+	h.erase_nodes(victims.begin(), victims.end());
+	CHECK(h.node_count() == 3);
+	CHECK(h.edge_count() == 1);
+	CHECK(h.out_degree(2) == 0);
+	CHECK(h.in_degree(1) == 1);
+	h.clear();
+	CHECK(h.node_count() == 0);
+	CHECK(h.edge_count() == 0);
+	CHECK_THROWS_MATCHES(h.out_degree(2),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot call gdwg::graph<N, E>::out_degree if src "
+	                                              "doesn't exist in the graph"));
+}
+TEST_CASE("nodes_view") {
+	using graph = gdwg::graph<std::string, std::string>;
+	auto const vt1 = std::vector<graph::value_type>{
+	   {"how", "are", "a"},
+	   {"are", "you", "b"},
+	   {"you", "how", "c"},
+	};
+	auto h = graph(vt1.begin(), vt1.end());
+	auto const view = h.nodes_view();
+	CHECK(std::vector<std::string>(view.begin(), view.end()) == h.nodes());
+	CHECK(&*view.begin() == &*h.nodes_view().begin()); // the values stored in the graph
+	auto long_names = view | ranges::views::filter([](auto const& i) { return i.size() > 3; });
+	CHECK(long_names.begin() == long_names.end());
+	auto sizes = view | ranges::views::transform([](auto const& i) { return i.size(); });
+	CHECK(std::vector<std::size_t>(sizes.begin(), sizes.end()) == std::vector<std::size_t>{3, 3, 3});
+	CHECK(graph{}.nodes_view().empty());
+	static_assert(ranges::bidirectional_iterator<decltype(view.begin())>);
+	static_assert(std::is_same_v<decltype(*view.begin()), std::string const&>);
+}
+TEST_CASE("out_edges") {
+	using graph = gdwg::graph<std::string, std::string>;
+	auto const vt1 = std::vector<graph::value_type>{
+	   {"how", "are", "b"},
+	   {"how", "are", "a"},
+	   {"how", "you", "c"},
+	   {"are", "you", "d"},
+	};
+	auto h = graph(vt1.begin(), vt1.end());
+	h.insert_node("alone");
+	auto const view = h.out_edges("how");
+	auto edges = std::vector<std::tuple<std::string, std::string, std::string>>{};
+	for (auto const& [from, to, weight] : view) {
+		edges.emplace_back(from, to, weight);
+	}
+	CHECK(edges
+	      == std::vector<std::tuple<std::string, std::string, std::string>>{{"how", "are", "a"},
+	                                                                         {"how", "are", "b"},
+	                                                                         {"how", "you", "c"}});
+	CHECK(&std::get<0>(*view.begin()) == &std::get<0>(*h.out_edges("how").begin()));
+	auto weights = view | ranges::views::transform([](auto const& i) { return std::get<2>(i); });
+	CHECK(std::vector<std::string>(weights.begin(), weights.end())
+	      == std::vector<std::string>{"a", "b", "c"});
+	CHECK(h.out_edges("alone").empty());
+	CHECK(h.out_edges("you").empty());
+	CHECK_THROWS_MATCHES(h.out_edges("who"),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot call gdwg::graph<N, E>::out_edges if src "
+	                                              "doesn't exist in the graph"));
+	static_assert(ranges::bidirectional_iterator<decltype(view.begin())>);
+}
+TEST_CASE("weights_view") {
+	using graph = gdwg::graph<std::string, std::string>;
+	auto const vt1 = std::vector<graph::value_type>{
+	   {"how", "are", "b"},
+	   {"how", "are", "a"},
+	   {"how", "you", "c"},
+	};
+	auto h = graph(vt1.begin(), vt1.end());
+	auto const view = h.weights_view("how", "are");
+	CHECK(std::vector<std::string>(view.begin(), view.end()) == h.weights("how", "are"));
+	CHECK(&*view.begin() == &*h.weights_view("how", "are").begin());
+	CHECK(h.weights_view("are", "how").empty());
+	CHECK_THROWS_MATCHES(h.weights_view("how", "who"),
+	                     std::runtime_error,
+	                     Catch::Matchers::Message("Cannot call gdwg::graph<N, E>::weights_view if "
+	                                              "src or dst node don't exist in the graph"));
+	static_assert(ranges::bidirectional_iterator<decltype(view.begin())>);
+	static_assert(std::is_same_v<decltype(*view.begin()), std::string const&>);
 }
 TEST_CASE("begin") {
 	using graph = gdwg::graph<int, int>;
@@ -562,6 +1121,162 @@ TEST_CASE("operator==") {
 	CHECK(h == g);
 	h.insert_edge(1, 1, 0);
 	CHECK_FALSE(h == g);
+
+	// as many nodes and edges, edges differing in one of src, dst and weight
+	auto const vt2 = std::vector<graph::value_type>{
+	   {1, 1, 1},
+	   {1, 2, 4},
+	   {2, 1, 1},
+	};
+	auto const vt3 = std::vector<graph::value_type>{
+	   {1, 1, 1},
+	   {2, 1, 3},
+	   {2, 1, 1},
+	};
+	CHECK_FALSE(graph(vt2.begin(), vt2.end()) == g);
+	CHECK_FALSE(graph(vt3.begin(), vt3.end()) == g);
+	CHECK_FALSE(g == graph{1, 3});
+
+	// the same graph, with its nodes interned in another order
+	auto k = graph{2, 1};
+	k.insert_edge(2, 1, 1);
+	k.insert_edge(1, 2, 3);
+	k.insert_edge(1, 1, 1);
+	CHECK(k == g);
+	CHECK(g == k);
+	k.replace_node(2, 5);
+	k.replace_node(5, 2);
+	CHECK(k == g);
+	k.erase_edge(1, 2, 3);
+	k.insert_edge(1, 2, 4);
+	CHECK_FALSE(k == g);
+
+	using flat_graph = gdwg::graph<int, int, gdwg::flat_storage>;
+	auto const vt1_flat = std::vector<flat_graph::value_type>{{1, 1, 1}, {1, 2, 3}, {2, 1, 1}};
+	auto const vt2_flat = std::vector<flat_graph::value_type>{{1, 1, 1}, {1, 2, 4}, {2, 1, 1}};
+	CHECK(flat_graph(vt1_flat.begin(), vt1_flat.end())
+	      == flat_graph(vt1_flat.begin(), vt1_flat.end()));
+	CHECK_FALSE(flat_graph(vt1_flat.begin(), vt1_flat.end())
+	            == flat_graph(vt2_flat.begin(), vt2_flat.end()));
+}
+
+namespace {
+	// The same nodes and edges as g, inserted one by one in the order of g.
+	template<typename G>
+	auto rebuilt(G const& g) -> G {
+		auto result = G{};
+		for (auto const& node : g.nodes()) {
+			result.insert_node(node);
+		}
+		for (auto const& [from, to, weight] : g) {
+			result.insert_edge(from, to, weight);
+		}
+		return result;
+	}
+} // namespace
+
+TEST_CASE("fingerprint") {
+	using graph = gdwg::graph<std::string, int>;
+	auto const vt = std::vector<graph::value_type>{
+	   {"a", "b", 1},
+	   {"a", "b", 2},
+	   {"b", "a", 1},
+	   {"b", "c", 3},
+	   {"c", "c", 4},
+	   {"d", "a", 5},
+	};
+	auto g = graph(vt.begin(), vt.end());
+	CHECK(g.fingerprint() == rebuilt(g).fingerprint());
+	CHECK(g.fingerprint() != graph{}.fingerprint());
+	CHECK(std::hash<graph>{}(g) == g.fingerprint());
+
+	// inserted in another order, or into flat storage, the graph is the same
+	auto reversed = graph{};
+	for (auto i = vt.rbegin(); i != vt.rend(); ++i) {
+		reversed.insert_node(i->to);
+		reversed.insert_node(i->from);
+		reversed.insert_edge(i->from, i->to, i->weight);
+	}
+	CHECK(reversed.fingerprint() == g.fingerprint());
+	using flat_graph = gdwg::graph<std::string, int, gdwg::flat_storage>;
+	auto flat_vt = std::vector<flat_graph::value_type>{};
+	for (auto const& [from, to, weight] : vt) {
+		flat_vt.push_back({from, to, weight});
+	}
+	auto flat = flat_graph(flat_vt.begin(), flat_vt.end());
+	CHECK(flat.fingerprint() == g.fingerprint());
+
+	// edges that swap their src and dst, or a node and a weight, hash differently
+	CHECK(graph{"a", "b"}.fingerprint() != graph{"a", "c"}.fingerprint());
+	auto ab = graph{"a", "b"};
+	auto ba = graph{"a", "b"};
+	ab.insert_edge("a", "b", 1);
+	ba.insert_edge("b", "a", 1);
+	CHECK(ab.fingerprint() != ba.fingerprint());
+	ba.erase_edge("b", "a", 1);
+	ba.insert_edge("a", "b", 2);
+	CHECK(ab.fingerprint() != ba.fingerprint());
+
+	// every modifier keeps it equal to the fingerprint of the graph built from scratch
+	auto const check = [](auto const& h) { CHECK(h.fingerprint() == rebuilt(h).fingerprint()); };
+	auto const snapshot = g;
+	auto const before = g.fingerprint();
+	g.insert_node("e");
+	check(g);
+	CHECK(g.fingerprint() != before);
+	CHECK(snapshot.fingerprint() == before); // a copy is not written through
+	g.insert_edge("e", "a", 6);
+	check(g);
+	g.replace_node("c", "z"); // with a reflexive edge
+	check(g);
+	g.replace_node("z", "c");
+	check(g);
+	g.merge_replace_node("b", "a"); // "b" -> "a" 1 and "a" -> "b" 1 merge into one edge
+	check(g);
+	g.erase_node("d");
+	check(g);
+	g.erase_edge("c", "c", 4);
+	check(g);
+	g.erase_edge(g.begin());
+	check(g);
+	g.insert_edge("a", "e", 7);
+	g.insert_edge("a", "e", 8);
+	g.erase_edge(g.begin(), std::next(g.begin(), 2));
+	check(g);
+	auto const batch = std::vector<graph::value_type>{{"a", "c", 9}, {"c", "a", 9}, {"a", "c", 9}};
+	CHECK(g.insert_edges(batch.begin(), batch.end()) == 2);
+	check(g);
+	CHECK(g.erase_edges(batch.begin(), batch.end()) == 2);
+	check(g);
+	auto const doomed = std::vector<std::string>{"a", "e"};
+	g.erase_nodes(doomed.begin(), doomed.end());
+	check(g);
+	g.clear();
+	CHECK(g.fingerprint() == graph{}.fingerprint());
+
+	// flat storage takes other paths through the same modifiers
+	flat.replace_node("c", "z");
+	check(flat);
+	flat.merge_replace_node("b", "a");
+	check(flat);
+	auto const flat_batch = std::vector<flat_graph::value_type>{{"a", "z", 9}, {"a", "z", 9}};
+	flat.insert_edges(flat_batch.begin(), flat_batch.end());
+	CHECK(flat.erase_edges(flat_batch.begin(), flat_batch.end()) == 1);
+	check(flat);
+	flat.erase_edge(flat.begin(), std::next(flat.begin()));
+	check(flat);
+	flat.erase_node("z");
+	check(flat);
+	auto const flat_doomed = std::vector<std::string>{"d"};
+	flat.erase_nodes(flat_doomed.begin(), flat_doomed.end());
+	check(flat);
+
+	// graphs are found by content in a hash set
+	auto seen = std::unordered_set<graph>{};
+	seen.insert(snapshot);
+	CHECK(seen.contains(rebuilt(snapshot)));
+	CHECK(seen.contains(reversed));
+	CHECK_FALSE(seen.contains(graph{"a"}));
 }
 
 TEST_CASE("operator*") {
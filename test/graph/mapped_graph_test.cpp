@@ -0,0 +1,263 @@
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "gdwg/graph.hpp"
+#include "gdwg/mapped_graph.hpp"
+
+#include <catch2/catch.hpp>
+
+namespace {
+	using graph = gdwg::graph<int, double>;
+	using flat_graph = gdwg::graph<int, double, gdwg::flat_storage>;
+	using mapped_graph = gdwg::mapped_graph<int, double>;
+	using edge_list = std::vector<std::tuple<int, int, double>>;
+
+	auto make_graph() -> graph {
+		auto const vt = std::vector<graph::value_type>{
+		   {2, 1, 1.5},
+		   {2, 3, 3},
+		   {2, 3, 2},
+		   {2, 2, 4},
+		   {4, 1, -5},
+		   {9, 4, 0.25},
+		};
+		auto g = graph(vt.begin(), vt.end());
+		g.insert_node(0); // sorts before every node with edges
+		g.insert_node(12); // sorts after them
+		g.insert_node(3); // has incoming edges only
+		g.insert_node(7);
+		g.insert_node(5); // sits between two nodes with edges
+		g.erase_node(7); // leaves an unused id behind
+		return g;
+	}
+
+	template<typename G>
+	auto edges_of(G const& g) -> edge_list {
+		auto result = edge_list{};
+		for (auto const& [from, to, weight] : g) {
+			result.emplace_back(from, to, weight);
+		}
+		return result;
+	}
+
+	auto to_bytes(graph const& g) -> std::string {
+		auto out = std::ostringstream{};
+		gdwg::write_binary(out, g);
+		return out.str();
+	}
+
+	// The bytes with value written over the ones at offset, and the checksum computed again, so that
+	// only the check of the sections can tell that something is wrong.
+	template<typename T>
+	auto resealed(std::string bytes, std::size_t offset, T const& value) -> std::string {
+		std::memcpy(bytes.data() + offset, &value, sizeof(value));
+		auto const checksum_offset = bytes.size() - sizeof(std::uint64_t);
+		auto sum = gdwg::detail::checksum{};
+		sum.update(reinterpret_cast<std::byte const*>(bytes.data()), checksum_offset);
+		auto const stored = sum.value();
+		std::memcpy(bytes.data() + checksum_offset, &stored, sizeof(stored));
+		return bytes;
+	}
+
+	// A file in the temporary directory, removed when it goes out of scope.
+	struct temp_file {
+		std::filesystem::path path;
+
+		temp_file(std::string const& name, std::string const& bytes)
+		: path{std::filesystem::temp_directory_path() / ("gdwg_mapped_graph_test_" + name)} {
+			auto out = std::ofstream(path, std::ios::binary);
+			out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+		}
+		temp_file(temp_file const&) = delete;
+		auto operator=(temp_file const&) -> temp_file& = delete;
+		~temp_file() {
+			std::filesystem::remove(path);
+		}
+	};
+} // namespace
+
+TEST_CASE("write_binary and read_binary") {
+	auto const g = make_graph();
+	auto const bytes = to_bytes(g);
+	CHECK(bytes.size() % 8 == 0);
+	CHECK(to_bytes(g) == bytes); // padding is written as zeros
+
+	auto in = std::istringstream(bytes);
+	auto const read = gdwg::read_binary<int, double>(in);
+	CHECK(read.nodes() == g.nodes());
+	CHECK(edges_of(read) == edges_of(g));
+	CHECK(!read.is_node(7));
+
+	auto flat_in = std::istringstream(bytes);
+	auto const flat = gdwg::read_binary<int, double, gdwg::flat_storage>(flat_in);
+	CHECK(flat.nodes() == g.nodes());
+	CHECK(edges_of(flat) == edges_of(g));
+
+	// a graph written from flat storage is the same file
+	auto const flat_edges = edges_of(g);
+	auto h = flat_graph{};
+	for (auto const node : g.nodes()) {
+		h.insert_node(node);
+	}
+	for (auto const& [from, to, weight] : flat_edges) {
+		h.insert_edge(from, to, weight);
+	}
+	auto out = std::ostringstream{};
+	gdwg::write_binary(out, h);
+	CHECK(out.str() == bytes);
+
+	auto empty_in = std::istringstream(to_bytes(graph{}));
+	CHECK(gdwg::read_binary<int, double>(empty_in).empty());
+	auto nodes_in = std::istringstream(to_bytes(graph{3, 1}));
+	CHECK(gdwg::read_binary<int, double>(nodes_in).nodes() == std::vector<int>{1, 3});
+}
+
+TEST_CASE("read_binary rejects bad files") {
+	auto const bytes = to_bytes(make_graph());
+	auto const read = [](std::string const& from) {
+		auto in = std::istringstream(from);
+		return gdwg::read_binary<int, double>(in);
+	};
+	CHECK_THROWS_WITH(read("not a graph file, but long enough to hold a header of one"),
+	                  "Cannot call gdwg::read_binary if the file is not a graph file");
+	CHECK_THROWS_WITH(read(bytes.substr(0, 20)),
+	                  "Cannot call gdwg::read_binary if the file is truncated");
+	CHECK_THROWS_WITH(read(bytes.substr(0, bytes.size() - 1)),
+	                  "Cannot call gdwg::read_binary if the file is truncated");
+	auto corrupt = bytes;
+	corrupt[64] = static_cast<char>(corrupt[64] ^ 1); // the first node
+	CHECK_THROWS_WITH(read(corrupt), "Cannot call gdwg::read_binary if the checksum doesn't match");
+	auto version = bytes;
+	version[8] = 2;
+	CHECK_THROWS_WITH(read(version),
+	                  "Cannot call gdwg::read_binary if the file has an unsupported version");
+	auto in = std::istringstream(bytes);
+	CHECK_THROWS_WITH((gdwg::read_binary<int, float>(in)),
+	                  "Cannot call gdwg::read_binary if the file holds other node or weight types");
+	// counts far beyond the length of the file are found out before they are allocated
+	auto huge = bytes;
+	auto const node_count = std::uint64_t{4'000'000'000};
+	auto const edge_count = std::uint64_t{1} << 40;
+	std::memcpy(huge.data() + offsetof(gdwg::detail::file_header, node_count),
+	            &node_count,
+	            sizeof(node_count));
+	std::memcpy(huge.data() + offsetof(gdwg::detail::file_header, edge_count),
+	            &edge_count,
+	            sizeof(edge_count));
+	CHECK_THROWS_WITH(read(huge), "Cannot call gdwg::read_binary if the file is truncated");
+}
+
+TEST_CASE("read_binary and mapped_graph reject inconsistent files with a valid checksum") {
+	auto const bytes = to_bytes(make_graph());
+	// 8 nodes, 0 1 2 3 4 5 9 12, and 6 edges, the first two out of node 2
+	auto const layout = gdwg::detail::make_layout<int, double>(8, 6);
+	auto const offset_at = [&layout](std::size_t i) {
+		return layout.offsets + i * sizeof(std::uint64_t);
+	};
+	auto const bad_files = std::vector<std::string>{
+	   resealed(bytes, layout.dsts, std::uint32_t{1'000'000}), // a dst past the nodes
+	   resealed(bytes, layout.dsts + sizeof(std::uint32_t), std::uint32_t{8}),
+	   resealed(bytes, offset_at(0), std::uint64_t{1}),
+	   resealed(bytes, offset_at(1), std::uint64_t{3}), // offsets go down after it
+	   resealed(bytes, offset_at(8), std::uint64_t{5}), // one edge less than the header
+	   resealed(bytes, offset_at(8), std::uint64_t{1'000'000}),
+	   resealed(bytes, layout.nodes, 100), // nodes out of order
+	   resealed(bytes, layout.nodes + sizeof(int), 0), // a duplicate node
+	   // node 2 has edges to 1, 2, 3 and 3, weighing 1.5, 4, 2 and 3
+	   resealed(bytes, layout.dsts + sizeof(std::uint32_t), std::uint32_t{0}), // dsts out of order
+	   resealed(bytes, layout.weights + 3 * sizeof(double), 1.0), // weights out of order
+	   resealed(bytes, layout.weights + 3 * sizeof(double), 2.0), // a duplicate edge
+	};
+	auto const caller = std::string("Cannot call gdwg::mapped_graph<N, E>::mapped_graph if ");
+	for (auto const& bad : bad_files) {
+		auto in = std::istringstream(bad);
+		CHECK_THROWS_WITH((gdwg::read_binary<int, double>(in)),
+		                  "Cannot call gdwg::read_binary if the file is corrupt");
+		auto const file = temp_file("inconsistent", bad);
+		CHECK_THROWS_WITH(mapped_graph(file.path), caller + "the file is corrupt");
+	}
+	// a change that keeps the sections consistent is read: 2 -> 1 becomes 2 -> 0
+	auto in = std::istringstream(resealed(bytes, layout.dsts, std::uint32_t{0}));
+	auto const changed = gdwg::read_binary<int, double>(in);
+	CHECK(changed.nodes() == make_graph().nodes());
+	CHECK(changed.is_connected(2, 0));
+}
+
+TEST_CASE("mapped_graph agrees with the graph it was written from") {
+	auto const g = make_graph();
+	auto const file = temp_file("graph", to_bytes(g));
+	for (auto const check : {gdwg::file_check::full, gdwg::file_check::header_only}) {
+		auto const mapped = mapped_graph(file.path, check);
+		CHECK(!mapped.empty());
+		CHECK(mapped.nodes() == g.nodes());
+		CHECK(edges_of(mapped) == edges_of(g));
+		CHECK(std::distance(mapped.begin(), mapped.end()) == 6);
+		for (auto const src : g.nodes()) {
+			CHECK(mapped.is_node(src));
+			CHECK(mapped.connections(src) == g.connections(src));
+			for (auto const dst : g.nodes()) {
+				CHECK(mapped.is_connected(src, dst) == g.is_connected(src, dst));
+				CHECK(mapped.weights(src, dst) == g.weights(src, dst));
+			}
+		}
+		CHECK(!mapped.is_node(7));
+		auto const found = mapped.find(2, 3, 3);
+		REQUIRE(found != mapped.end());
+		CHECK(std::get<2>(*found) == 3);
+		CHECK(std::prev(mapped.end()) != mapped.begin());
+		CHECK(mapped.find(2, 3, 4) == mapped.end());
+		CHECK(mapped.find(7, 3, 3) == mapped.end());
+		CHECK_THROWS_WITH(mapped.is_connected(2, 7),
+		                  "Cannot call gdwg::mapped_graph<N, E>::is_connected if src or dst node "
+		                  "don't exist in the graph");
+		CHECK_THROWS_WITH(mapped.weights(7, 2),
+		                  "Cannot call gdwg::mapped_graph<N, E>::weights if src or dst node don't "
+		                  "exist in the graph");
+		CHECK_THROWS_WITH(mapped.connections(7),
+		                  "Cannot call gdwg::mapped_graph<N, E>::connections if src doesn't exist "
+		                  "in the graph");
+	}
+
+	// the mapping moves along with the graph
+	auto first = mapped_graph(file.path);
+	auto const second = std::move(first);
+	CHECK(second.nodes() == g.nodes());
+
+	auto const empty = temp_file("empty_graph", to_bytes(graph{}));
+	auto const mapped_empty = mapped_graph(empty.path);
+	CHECK(mapped_empty.empty());
+	CHECK(mapped_empty.begin() == mapped_empty.end());
+}
+
+TEST_CASE("mapped_graph rejects bad files") {
+	auto const bytes = to_bytes(make_graph());
+	auto const caller = std::string("Cannot call gdwg::mapped_graph<N, E>::mapped_graph if ");
+	CHECK_THROWS_WITH(mapped_graph(std::filesystem::temp_directory_path() / "gdwg_no_such_file"),
+	                  caller + "the file can't be opened");
+	auto const empty = temp_file("empty", "");
+	CHECK_THROWS_WITH(mapped_graph(empty.path), caller + "the file is not a graph file");
+	{
+		auto const truncated = temp_file("truncated", bytes.substr(0, bytes.size() - 8));
+		CHECK_THROWS_WITH(mapped_graph(truncated.path),
+		                  caller + "the size of the file doesn't match its header");
+	}
+	{
+		auto corrupt = bytes;
+		corrupt[bytes.size() - 9] = static_cast<char>(corrupt[bytes.size() - 9] ^ 1);
+		auto const file = temp_file("corrupt", corrupt);
+		CHECK_THROWS_WITH(mapped_graph(file.path), caller + "the checksum doesn't match");
+		// which only a full check reads
+		CHECK_NOTHROW(mapped_graph(file.path, gdwg::file_check::header_only));
+	}
+	auto const file = temp_file("graph", bytes);
+	CHECK_THROWS_WITH((gdwg::mapped_graph<int, int>(file.path)),
+	                  caller + "the file holds other node or weight types");
+}
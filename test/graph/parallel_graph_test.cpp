@@ -0,0 +1,59 @@
+#include <execution>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "gdwg/graph.hpp"
+#include "gdwg/parallel_graph.hpp"
+
+#include <catch2/catch.hpp>
+
+namespace {
+	template<typename G>
+	auto print(G const& g) -> std::string {
+		auto out = std::ostringstream{};
+		out << g;
+		return out.str();
+	}
+} // namespace
+
+TEST_CASE("build_graph builds the same graph as the serial constructor") {
+	using graph = gdwg::graph<std::string, int>;
+	auto engine = std::mt19937{6771};
+	auto node = std::uniform_int_distribution<int>{0, 499};
+	auto weights = std::uniform_int_distribution<int>{0, 3}; // plenty of duplicate edges
+	auto edges = std::vector<graph::value_type>{};
+	for (auto i = 0; i < 20'000; ++i) {
+		edges.push_back(
+		   {std::to_string(node(engine)), std::to_string(node(engine)), weights(engine)});
+	}
+	auto const serial = graph(edges.begin(), edges.end());
+	auto const parallel =
+	   gdwg::build_graph<std::string, int>(std::execution::par_unseq, edges.begin(), edges.end());
+	CHECK(print(parallel) == print(serial));
+	CHECK(parallel == serial);
+	CHECK(parallel.nodes() == serial.nodes());
+	CHECK(parallel.connections("7") == serial.connections("7"));
+
+	using flat_graph = gdwg::graph<std::string, int, gdwg::flat_storage>;
+	auto flat_edges = std::vector<flat_graph::value_type>{};
+	for (auto const& [from, to, weight] : edges) {
+		flat_edges.push_back({from, to, weight});
+	}
+	auto const flat = gdwg::build_graph<std::string, int, gdwg::flat_storage>(std::execution::par,
+	                                                                          flat_edges.begin(),
+	                                                                          flat_edges.end());
+	CHECK(print(flat) == print(serial));
+}
+
+TEST_CASE("build_graph on small and empty ranges") {
+	using graph = gdwg::graph<std::string, int>;
+	auto const few = std::vector<graph::value_type>{{"B", "A", 1}, {"A", "B", 2}, {"B", "A", 1}};
+	auto const small =
+	   gdwg::build_graph<std::string, int>(std::execution::par, few.begin(), few.end());
+	CHECK(small.nodes() == std::vector<std::string>{"A", "B"});
+	CHECK(small.weights("B", "A") == std::vector<int>{1});
+	CHECK(small.edge_count() == 2);
+	CHECK(gdwg::build_graph<std::string, int>(std::execution::seq, few.end(), few.end()).empty());
+}
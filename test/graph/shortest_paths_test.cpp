@@ -0,0 +1,194 @@
+#include <algorithm>
+#include <map>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gdwg/graph.hpp"
+#include "gdwg/shortest_paths.hpp"
+
+#include <catch2/catch.hpp>
+
+namespace {
+	using graph = gdwg::graph<int, int>;
+	using flat_graph = gdwg::graph<int, int, gdwg::flat_storage>;
+
+	// The graph of client.cpp, which has negative weights but no negative cycle.
+	auto const client_edges = std::vector<graph::value_type>{
+	   {4, 1, -4},
+	   {3, 2, 2},
+	   {2, 4, 2},
+	   {2, 1, 1},
+	   {6, 2, 5},
+	   {6, 3, 10},
+	   {1, 5, -1},
+	   {3, 6, -8},
+	   {4, 5, 3},
+	   {5, 2, 7},
+	};
+
+	// Bellman-Ford through the public interface, the way shortest paths were found before.
+	template<typename G>
+	auto reference_distances(G const& g, int src) -> std::map<int, int> {
+		auto dist = std::map<int, int>{{src, 0}};
+		for (auto round = std::size_t{0}; round < g.nodes().size(); ++round) {
+			for (auto const& [from, to, weight] : g) {
+				auto const found = dist.find(from);
+				if (found == dist.end()) {
+					continue;
+				}
+				auto const length = found->second + weight;
+				if (auto const [iter, inserted] = dist.emplace(to, length); !inserted) {
+					iter->second = std::min(iter->second, length);
+				}
+			}
+		}
+		return dist;
+	}
+
+	// Checks that path(dst) is made of edges of g and is as long as distance(dst).
+	template<typename G>
+	auto check_path(G const& g, gdwg::shortest_paths<int, int> const& paths, int dst) -> void {
+		auto const path = paths.path(dst);
+		REQUIRE(!path.empty());
+		CHECK(path.front() == paths.source());
+		CHECK(path.back() == dst);
+		auto length = 0;
+		for (auto i = std::size_t{1}; i < path.size(); ++i) {
+			auto const weights = g.weights(path[i - 1], path[i]);
+			REQUIRE(!weights.empty());
+			length += weights.front(); // the lightest edge between them
+		}
+		CHECK(paths.distance(dst) == length);
+	}
+} // namespace
+
+TEST_CASE("dijkstra(g, src)") {
+	auto const vt = std::vector<graph::value_type>{
+	   {1, 2, 7},
+	   {1, 3, 9},
+	   {1, 6, 14},
+	   {2, 3, 10},
+	   {2, 4, 15},
+	   {3, 4, 11},
+	   {3, 6, 2},
+	   {4, 5, 6},
+	   {6, 5, 9},
+	   {6, 5, 1}, // a lighter parallel edge
+	   {7, 1, 1},
+	};
+	auto const g = graph(vt.begin(), vt.end());
+	auto const paths = gdwg::dijkstra(g, 1);
+	CHECK(paths.source() == 1);
+	CHECK(paths.distance(1) == 0);
+	CHECK(paths.distance(2) == 7);
+	CHECK(paths.distance(3) == 9);
+	CHECK(paths.distance(4) == 20);
+	CHECK(paths.distance(5) == 12);
+	CHECK(paths.distance(6) == 11);
+	CHECK(paths.path(5) == std::vector<int>{1, 3, 6, 5});
+	CHECK(paths.path(1) == std::vector<int>{1});
+	CHECK(paths.negative_cycle().empty());
+
+	CHECK(!paths.reachable(7));
+	CHECK(paths.distance(7) == std::nullopt);
+	CHECK(paths.path(7).empty());
+
+	CHECK_THROWS_WITH(gdwg::dijkstra(g, 8),
+	                  "Cannot call gdwg::dijkstra if src doesn't exist in the graph");
+	CHECK_THROWS_WITH(paths.distance(8),
+	                  "Cannot call gdwg::shortest_paths<N, E>::distance if dst doesn't exist in "
+	                  "the graph");
+	auto const negative = graph(client_edges.begin(), client_edges.end());
+	CHECK_THROWS_WITH(gdwg::dijkstra(negative, 3),
+	                  "Cannot call gdwg::dijkstra if a reachable edge has a negative weight");
+}
+
+TEST_CASE("bellman_ford(g, src)") {
+	auto const g = graph(client_edges.begin(), client_edges.end());
+	auto const paths = gdwg::bellman_ford(g, 3);
+	CHECK(paths.negative_cycle().empty());
+	auto const expected = reference_distances(g, 3);
+	for (auto const node : g.nodes()) {
+		CHECK(paths.distance(node) == expected.at(node));
+		check_path(g, paths, node);
+	}
+	CHECK(paths.distance(6) == -8);
+	CHECK(paths.path(5) == std::vector<int>{3, 6, 2, 4, 1, 5});
+	CHECK(gdwg::bellman_ford(g, 5).distance(3) == std::nullopt);
+	CHECK_THROWS_WITH(gdwg::bellman_ford(g, 7),
+	                  "Cannot call gdwg::bellman_ford if src doesn't exist in the graph");
+}
+
+TEST_CASE("bellman_ford finds negative cycles") {
+	auto const vt = std::vector<graph::value_type>{
+	   {1, 2, 1},
+	   {2, 3, -2},
+	   {3, 2, 1},
+	   {3, 4, 1},
+	   {1, 5, 1},
+	   {6, 1, 1},
+	};
+	auto const g = graph(vt.begin(), vt.end());
+	auto const paths = gdwg::bellman_ford(g, 1);
+	auto cycle = paths.negative_cycle();
+	REQUIRE(cycle.size() == 2);
+	std::rotate(cycle.begin(), std::min_element(cycle.begin(), cycle.end()), cycle.end());
+	CHECK(cycle == std::vector<int>{2, 3});
+	CHECK(paths.distance(1) == 0);
+	CHECK(paths.distance(5) == 1);
+	CHECK(paths.distance(6) == std::nullopt);
+	CHECK(paths.reachable(4));
+	CHECK_THROWS_WITH(paths.distance(4),
+	                  "Cannot call gdwg::shortest_paths<N, E>::distance if a negative cycle leads "
+	                  "to dst");
+	CHECK_THROWS_WITH(paths.path(2),
+	                  "Cannot call gdwg::shortest_paths<N, E>::path if a negative cycle leads to "
+	                  "dst");
+
+	auto const self_loop = std::vector<graph::value_type>{{1, 1, -1}};
+	auto const h = graph(self_loop.begin(), self_loop.end());
+	CHECK(gdwg::bellman_ford(h, 1).negative_cycle() == std::vector<int>{1});
+}
+
+TEST_CASE("dijkstra and bellman_ford agree with the reference on random graphs") {
+	auto engine = std::mt19937{6771};
+	auto node = std::uniform_int_distribution<int>{0, 59};
+	auto weight = std::uniform_int_distribution<int>{0, 20};
+	auto g = graph{};
+	auto flat = flat_graph{};
+	for (auto i = 0; i < 300; ++i) {
+		auto const src = node(engine);
+		auto const dst = node(engine);
+		auto const w = weight(engine);
+		g.insert_node(src);
+		g.insert_node(dst);
+		g.insert_edge(src, dst, w);
+		flat.insert_node(src);
+		flat.insert_node(dst);
+		flat.insert_edge(src, dst, w);
+	}
+	// erased nodes leave unused ids behind
+	for (auto const victim : {3, 17, 42}) {
+		g.erase_node(victim);
+		flat.erase_node(victim);
+	}
+	for (auto const src : g.nodes()) {
+		auto const expected = reference_distances(g, src);
+		auto const by_dijkstra = gdwg::dijkstra(g, src);
+		auto const by_bellman_ford = gdwg::bellman_ford(g, src);
+		auto const on_flat = gdwg::dijkstra(flat, src);
+		for (auto const dst : g.nodes()) {
+			auto const found = expected.find(dst);
+			auto const distance =
+			   found == expected.end() ? std::nullopt : std::optional<int>(found->second);
+			CHECK(by_dijkstra.distance(dst) == distance);
+			CHECK(by_bellman_ford.distance(dst) == distance);
+			CHECK(on_flat.distance(dst) == distance);
+			if (distance) {
+				check_path(g, by_dijkstra, dst);
+			}
+		}
+	}
+}
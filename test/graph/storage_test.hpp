@@ -0,0 +1,184 @@
+#ifndef GDWG_TEST_STORAGE_TEST_HPP
+#define GDWG_TEST_STORAGE_TEST_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "gdwg/graph.hpp"
+
+#include <catch2/catch.hpp>
+
+// What the tests of every storage policy share: printing a graph, listing its edges, and checking
+// that a graph with that policy goes through random operations the same way as one with
+// tree_storage.
+namespace storage_test {
+	template<typename G>
+	auto print(G const& g) -> std::string {
+		auto out = std::ostringstream{};
+		out << g;
+		return out.str();
+	}
+
+	template<typename G>
+	auto edges_of(G const& g) -> std::vector<typename G::value_type> {
+		auto edges = std::vector<typename G::value_type>{};
+		for (auto const& [from, to, weight] : g) {
+			edges.push_back({from, to, weight});
+		}
+		return edges;
+	}
+
+	// How the random operations are drawn. Nodes are 0 to nodes - 1, and weights 0 to weights - 1.
+	// A node is erased, merged away, or one of a batch of nodes erased, when it is a multiple of
+	// the matching every, so that nodes are inserted more often than they go.
+	struct random_operations {
+		int nodes;
+		int weights;
+		int merge_every;
+		int erase_every;
+		int erase_nodes_every;
+		int batch_dsts; // edges inserted out of each node by a batch, 1 to 3
+		std::size_t erase_stride; // a batch erases one edge in erase_stride
+	};
+
+	// Runs the same random operations on a tree backed graph and one with Storage, and checks they
+	// always hold the same nodes and edges and answer queries the same way. copy(g) is called on
+	// the graph with Storage every so often, to take a copy of it or a snapshot. Returns the most
+	// edges the graphs held.
+	template<typename Storage, typename F>
+	auto check_like_tree_storage(random_operations const& ops, F copy) -> std::size_t {
+		using tree_graph = gdwg::graph<int, int>;
+		using other_graph = gdwg::graph<int, int, Storage>;
+		auto engine = std::mt19937{6771};
+		auto value = std::uniform_int_distribution<int>{0, ops.nodes - 1};
+		auto operation = std::uniform_int_distribution<int>{0, 11};
+		auto tree = tree_graph{};
+		auto other = other_graph{};
+		auto most_edges = std::size_t{0};
+		for (auto step = 0; step < 3000; ++step) {
+			auto const a = value(engine);
+			auto const b = value(engine);
+			auto const w = value(engine) % ops.weights;
+			switch (operation(engine)) {
+			case 0: CHECK(tree.insert_node(a) == other.insert_node(a)); break;
+			case 1:
+			case 2:
+				if (tree.is_node(a) and tree.is_node(b)) {
+					CHECK(tree.insert_edge(a, b, w) == other.insert_edge(a, b, w));
+				}
+				break;
+			case 3:
+				if (tree.is_node(a)) {
+					CHECK(tree.replace_node(a, b) == other.replace_node(a, b));
+				}
+				break;
+			case 4:
+				if (a % ops.merge_every == 0 and tree.is_node(a) and tree.is_node(b)) {
+					tree.merge_replace_node(a, b);
+					other.merge_replace_node(a, b);
+				}
+				break;
+			case 5:
+				if (a % ops.erase_every == 0) {
+					CHECK(tree.erase_node(a) == other.erase_node(a));
+				}
+				break;
+			case 6:
+				if (tree.is_node(a) and tree.is_node(b)) {
+					CHECK(tree.erase_edge(a, b, w) == other.erase_edge(a, b, w));
+				}
+				break;
+			case 7: {
+				auto tree_iter = tree.find(a, b, w);
+				auto other_iter = other.find(a, b, w);
+				CHECK((tree_iter == tree.end()) == (other_iter == other.end()));
+				if (tree_iter != tree.end()) {
+					tree.erase_edge(tree_iter, tree.end());
+					other.erase_edge(other_iter, other.end());
+				}
+				break;
+			}
+			case 8: {
+				auto batch = std::vector<tree_graph::value_type>{};
+				auto converted = std::vector<typename other_graph::value_type>{};
+				for (auto const& node : tree.nodes()) {
+					auto const dsts = std::vector<int>{(node * 7 + a) % ops.nodes,
+					                                   (node * 3 + b) % ops.nodes,
+					                                   (node + a + b) % ops.nodes};
+					for (auto i = 0; i < ops.batch_dsts; ++i) {
+						auto const dst = dsts[static_cast<std::size_t>(i)];
+						if (tree.is_node(dst)) {
+							batch.push_back({node, dst, w});
+							converted.push_back({node, dst, w});
+						}
+					}
+				}
+				CHECK(tree.insert_edges(batch.begin(), batch.end())
+				      == other.insert_edges(converted.begin(), converted.end()));
+				break;
+			}
+			case 9: {
+				auto const edges = edges_of(tree);
+				auto batch = std::vector<tree_graph::value_type>{};
+				for (auto i = std::size_t{0}; i < edges.size(); i += ops.erase_stride) {
+					batch.push_back(edges[i]);
+				}
+				auto converted = std::vector<typename other_graph::value_type>{};
+				for (auto const& edge : batch) {
+					converted.push_back({edge.from, edge.to, edge.weight});
+				}
+				CHECK(tree.erase_edges(batch.begin(), batch.end())
+				      == other.erase_edges(converted.begin(), converted.end()));
+				break;
+			}
+			case 10: {
+				auto const victims = std::vector<int>{a, b, (a + b) % ops.nodes};
+				if (a % ops.erase_nodes_every == 0) {
+					CHECK(tree.erase_nodes(victims.begin(), victims.end())
+					      == other.erase_nodes(victims.begin(), victims.end()));
+				}
+				break;
+			}
+			case 11: copy(other); break;
+			}
+			REQUIRE(print(tree) == print(other));
+			CHECK(tree.node_count() == tree.nodes().size());
+			CHECK(other.node_count() == tree.node_count());
+			CHECK(tree.edge_count()
+			      == static_cast<std::size_t>(std::distance(tree.begin(), tree.end())));
+			CHECK(other.edge_count() == tree.edge_count());
+			CHECK(other.fingerprint() == tree.fingerprint());
+			most_edges = std::max(most_edges, tree.edge_count());
+			if (tree.is_node(a) and tree.is_node(b)) {
+				CHECK(tree.is_connected(a, b) == other.is_connected(a, b));
+				CHECK(tree.weights(a, b) == other.weights(a, b));
+				CHECK(tree.connections(a) == other.connections(a));
+				// the reverse index agrees with the edges themselves
+				auto expected = std::vector<int>{};
+				auto degree = std::size_t{0};
+				for (auto const& node : tree.nodes()) {
+					if (tree.is_connected(node, b)) {
+						expected.push_back(node);
+						degree += tree.weights(node, b).size();
+					}
+				}
+				CHECK(tree.predecessors(b) == expected);
+				CHECK(other.predecessors(b) == expected);
+				CHECK(tree.in_degree(b) == degree);
+				CHECK(other.in_degree(b) == degree);
+				auto const edges = tree.out_edges(a);
+				auto const out = static_cast<std::size_t>(std::distance(edges.begin(), edges.end()));
+				CHECK(tree.out_degree(a) == out);
+				CHECK(other.out_degree(a) == out);
+			}
+		}
+		return most_edges;
+	}
+} // namespace storage_test
+
+#endif // GDWG_TEST_STORAGE_TEST_HPP
@@ -0,0 +1,228 @@
+#include <compare>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <ostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "gdwg/graph.hpp"
+#include "gdwg/text_format.hpp"
+
+#include <catch2/catch.hpp>
+
+namespace {
+	template<typename G>
+	auto print(G const& g) -> std::string {
+		auto out = std::ostringstream{};
+		out << g;
+		return out.str();
+	}
+
+	template<typename G>
+	auto write(G const& g) -> std::string {
+		auto out = std::string{};
+		gdwg::write_graph(g, [&out](std::string_view text) { out.append(text); });
+		return out;
+	}
+
+	// Written by its operator<< only, which write_graph falls back to.
+	struct point {
+		int x;
+		int y;
+		auto operator<=>(point const&) const = default;
+	};
+	auto operator<<(std::ostream& os, point const& p) -> std::ostream& {
+		return os << '<' << p.x << ", " << p.y << '>';
+	}
+} // namespace
+
+TEST_CASE("parse_graph reads back what operator<< writes") {
+	using graph = gdwg::graph<int, int>;
+	auto const vt = std::vector<graph::value_type>{
+	   {4, 1, -4},
+	   {3, 2, 2},
+	   {2, 4, 2},
+	   {2, 1, 1},
+	   {6, 2, 5},
+	   {6, 3, 10},
+	   {1, 5, -1},
+	   {3, 6, -8},
+	   {4, 5, 3},
+	   {5, 2, 7},
+	};
+	auto g = graph(vt.begin(), vt.end());
+	g.insert_node(64);
+	g.insert_node(-3);
+	auto const text = print(g);
+	auto const parsed = gdwg::parse_graph<int, int>(text);
+	CHECK(print(parsed) == text);
+	CHECK(parsed.nodes() == g.nodes());
+	CHECK(parsed.weights(4, 1) == std::vector<int>{-4});
+
+	auto in = std::istringstream(text);
+	CHECK(print(gdwg::parse_graph<int, int>(in)) == text);
+	auto const flat = gdwg::parse_graph<int, int, gdwg::flat_storage>(text);
+	CHECK(print(flat) == text);
+
+	CHECK(gdwg::parse_graph<int, int>("").empty());
+	CHECK(print(gdwg::parse_graph<int, int>("1 (\n)")) == "1 (\n)\n"); // no final line break
+}
+
+TEST_CASE("parse_graph loads the nodes without edges along with the edges") {
+	using graph = gdwg::graph<int, int, gdwg::flat_storage>;
+	auto g = graph{};
+	for (auto i = 0; i < 3000; ++i) {
+		g.insert_node(3 * i); // mostly nodes without edges, some of them dsts
+	}
+	for (auto i = 0; i < 300; ++i) {
+		g.insert_edge(30 * i, 3 * ((7 * i) % 3000), i);
+	}
+	auto const text = print(g);
+	auto const parsed = gdwg::parse_graph<int, int, gdwg::flat_storage>(text);
+	CHECK(parsed == g);
+	CHECK(parsed.node_count() == 3000);
+	CHECK(print(parsed) == text);
+	CHECK(gdwg::parse_graph<int, int>("2 (\n)\n1 (\n)\n").nodes() == std::vector<int>{1, 2});
+}
+
+TEST_CASE("parse_graph reads strings and floating point numbers") {
+	using graph = gdwg::graph<std::string, double>;
+	auto const vt = std::vector<graph::value_type>{
+	   {"how are", "you", 0.5},
+	   {"how are", "you", -2},
+	   {"you", "", 1e+06},
+	   {"a | b (", "how are", 3.25},
+	};
+	auto g = graph(vt.begin(), vt.end());
+	g.insert_node("lonely");
+	auto const text = print(g);
+	auto const parsed = gdwg::parse_graph<std::string, double>(text);
+	CHECK(print(parsed) == text);
+	CHECK(parsed.weights("how are", "you") == std::vector<double>{-2, 0.5});
+	CHECK(parsed.is_connected("a | b (", "how are"));
+	CHECK(parsed.is_connected("you", ""));
+	CHECK(parsed.is_node("lonely"));
+}
+
+TEST_CASE("parse_graph reads a stream across chunks and lines longer than a chunk") {
+	using graph = gdwg::graph<int, long>;
+	auto engine = std::mt19937{6771};
+	auto node = std::uniform_int_distribution<int>{-5000, 5000};
+	auto weight = std::uniform_int_distribution<long>{-1'000'000'000'000, 1'000'000'000'000};
+	auto g = graph{};
+	for (auto i = 0; i < 100'000; ++i) {
+		auto const src = node(engine);
+		auto const dst = node(engine);
+		g.insert_node(src);
+		g.insert_node(dst);
+		g.insert_edge(src, dst, weight(engine));
+	}
+	auto const text = print(g);
+	REQUIRE(text.size() > 2 * (std::size_t{1} << 20)); // several chunks
+	auto in = std::istringstream(text);
+	CHECK(print(gdwg::parse_graph<int, long>(in)) == text);
+
+	auto long_line = gdwg::graph<std::string, int>{};
+	long_line.insert_node(std::string(3 << 20, 'x'));
+	long_line.insert_node("y");
+	long_line.insert_edge("y", std::string(3 << 20, 'x'), 1);
+	auto const long_text = print(long_line);
+	auto long_in = std::istringstream(long_text);
+	CHECK(print(gdwg::parse_graph<std::string, int>(long_in)) == long_text);
+}
+
+TEST_CASE("parse_graph rejects malformed text") {
+	auto const parse = [](std::string_view text) { return gdwg::parse_graph<int, int>(text); };
+	CHECK_THROWS_WITH(parse("1 (\n  2 | 3\n"),
+	                  "Cannot call gdwg::parse_graph if line 3 is malformed");
+	CHECK_THROWS_WITH(parse("1\n)\n"), "Cannot call gdwg::parse_graph if line 1 is malformed");
+	CHECK_THROWS_WITH(parse("1 (\n2 | 3\n)\n"),
+	                  "Cannot call gdwg::parse_graph if line 2 is malformed");
+	CHECK_THROWS_WITH(parse("1 (\n  2 | 3x\n)\n"),
+	                  "Cannot call gdwg::parse_graph if line 2 is malformed");
+	CHECK_THROWS_WITH(parse("1 (\n  2 3\n)\n"),
+	                  "Cannot call gdwg::parse_graph if line 2 is malformed");
+	CHECK_THROWS_WITH(parse("1 (\n)\n)\n"), "Cannot call gdwg::parse_graph if line 3 is malformed");
+	CHECK_THROWS_WITH(parse("99999999999 (\n)\n"),
+	                  "Cannot call gdwg::parse_graph if line 1 is malformed");
+	CHECK_THROWS_WITH((gdwg::parse_graph<std::string, int>("a (\n  b | 1.5\n)\n")),
+	                  "Cannot call gdwg::parse_graph if line 2 is malformed");
+}
+
+TEST_CASE("write_graph writes what operator<< writes") {
+	auto const ints = std::vector<gdwg::graph<int, int>::value_type>{
+	   {4, 1, -4},
+	   {3, 2, 2},
+	   {2, 4, std::numeric_limits<int>::min()},
+	   {6, 3, 10},
+	};
+	auto i = gdwg::graph<int, int>(ints.begin(), ints.end());
+	i.insert_node(64);
+	CHECK(write(i) == print(i));
+	CHECK(write(gdwg::graph<int, int>{}).empty());
+
+	auto const doubles = std::vector<gdwg::graph<std::string, double>::value_type>{
+	   {"a", "b", 0.1},
+	   {"a", "b", 1.0 / 3},
+	   {"a", "", 1e+06},
+	   {"b", "a", -2.5e-7},
+	   {"b", "b", 123456789},
+	   {"b", "c", std::numeric_limits<double>::infinity()},
+	};
+	auto const d = gdwg::graph<std::string, double>(doubles.begin(), doubles.end());
+	CHECK(write(d) == print(d));
+
+	auto c = gdwg::graph<char, bool>{'a', 'b'};
+	c.insert_edge('a', 'b', true);
+	c.insert_edge('b', 'a', false);
+	CHECK(write(c) == print(c));
+	auto u = gdwg::graph<unsigned char, long long>{static_cast<unsigned char>('x')};
+	u.insert_edge('x', 'x', std::numeric_limits<long long>::max());
+	CHECK(write(u) == print(u));
+
+	auto p = gdwg::graph<point, point>{point{1, 2}, point{-3, 4}};
+	p.insert_edge(point{1, 2}, point{-3, 4}, point{5, 6});
+	CHECK(write(p) == print(p));
+}
+
+TEST_CASE("write_graph writes in chunks, to a file descriptor too") {
+	auto engine = std::mt19937{6771};
+	auto node = std::uniform_int_distribution<int>{-5000, 5000};
+	auto g = gdwg::graph<int, int>{};
+	for (auto i = 0; i < 20'000; ++i) {
+		auto const src = node(engine);
+		auto const dst = node(engine);
+		g.insert_node(src);
+		g.insert_node(dst);
+		g.insert_edge(src, dst, i);
+	}
+	auto const text = print(g);
+	auto chunks = 0;
+	auto out = std::string{};
+	gdwg::write_graph(g, [&chunks, &out](std::string_view chunk) {
+		++chunks;
+		out.append(chunk);
+	});
+	CHECK(out == text);
+	CHECK(chunks > 1);
+
+	auto const path = std::filesystem::temp_directory_path() / "gdwg_text_format_test.txt";
+	auto const fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0600);
+	REQUIRE(fd != -1);
+	gdwg::write_graph(g, fd);
+	::close(fd);
+	auto in = std::ifstream(path);
+	CHECK(std::string(std::istreambuf_iterator<char>(in), {}) == text);
+	std::filesystem::remove(path);
+
+	CHECK_THROWS_WITH(gdwg::write_graph(g, -1),
+	                  "Cannot call gdwg::write_graph if the file descriptor can't be written");
+}
@@ -0,0 +1,160 @@
+#include <algorithm>
+#include <execution>
+#include <random>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gdwg/graph.hpp"
+#include "gdwg/parallel_traversal.hpp"
+#include "gdwg/traversal.hpp"
+
+#include <catch2/catch.hpp>
+
+namespace {
+	using graph = gdwg::graph<int, int>;
+	using flat_graph = gdwg::graph<int, int, gdwg::flat_storage>;
+
+	// The reachable nodes as they were found before, through connections.
+	template<typename G>
+	auto reference_reachable(G const& g, int src) -> std::vector<int> {
+		auto seen = std::set<int>{src};
+		auto stack = std::vector<int>{src};
+		while (!stack.empty()) {
+			auto const u = stack.back();
+			stack.pop_back();
+			for (auto const v : g.connections(u)) {
+				if (seen.insert(v).second) {
+					stack.push_back(v);
+				}
+			}
+		}
+		return {seen.begin(), seen.end()};
+	}
+
+	// A graph of count random edges between nodes 0 to n - 1, and every one of those nodes.
+	template<typename G>
+	auto random_graph(int n, int count, unsigned seed) -> G {
+		auto engine = std::mt19937{seed};
+		auto node = std::uniform_int_distribution<int>{0, n - 1};
+		auto edges = std::vector<typename G::value_type>{};
+		for (auto i = 0; i < count; ++i) {
+			edges.push_back({node(engine), node(engine), i % 7});
+		}
+		auto g = G(edges.begin(), edges.end());
+		for (auto i = 0; i < n; ++i) {
+			g.insert_node(i);
+		}
+		return g;
+	}
+} // namespace
+
+TEST_CASE("traversal: breadth_first and depth_first") {
+	auto const vt = std::vector<graph::value_type>{
+	   {1, 3, 1},
+	   {1, 2, 1},
+	   {1, 2, 2}, // parallel edges lead to a node once
+	   {2, 4, 1},
+	   {3, 4, 1},
+	   {4, 1, 1},
+	   {4, 5, 1},
+	   {6, 1, 1},
+	};
+	auto const g = graph(vt.begin(), vt.end());
+	auto t = gdwg::traversal(g);
+
+	using visit_list = std::vector<std::pair<int, std::size_t>>;
+	auto visits = visit_list{};
+	auto const record = [&visits](int node, std::size_t depth) { visits.emplace_back(node, depth); };
+	t.breadth_first(1, record);
+	CHECK(visits == visit_list{{1, 0}, {2, 1}, {3, 1}, {4, 2}, {5, 3}});
+
+	visits.clear();
+	t.depth_first(1, record);
+	CHECK(visits == visit_list{{1, 0}, {2, 1}, {4, 2}, {5, 3}, {3, 1}});
+
+	// a visitor that returns false stops the search, and the next one starts afresh
+	visits.clear();
+	t.breadth_first(1, [&visits](int node, std::size_t depth) {
+		visits.emplace_back(node, depth);
+		return node != 2;
+	});
+	CHECK(visits == visit_list{{1, 0}, {2, 1}});
+	visits.clear();
+	t.depth_first(6, [&visits](int node, std::size_t depth) {
+		visits.emplace_back(node, depth);
+		return depth < 2;
+	});
+	CHECK(visits == visit_list{{6, 0}, {1, 1}, {2, 2}});
+	CHECK(t.reachable_from(6) == std::vector<int>{1, 2, 3, 4, 5, 6});
+
+	CHECK_THROWS_WITH(t.breadth_first(7, [](int, std::size_t) {}),
+	                  "Cannot call gdwg::traversal<N, E>::breadth_first if src doesn't exist in "
+	                  "the graph");
+	CHECK_THROWS_WITH(t.depth_first(7, [](int, std::size_t) {}),
+	                  "Cannot call gdwg::traversal<N, E>::depth_first if src doesn't exist in the "
+	                  "graph");
+}
+
+TEST_CASE("traversal: reachable(src, dst, max_hops)") {
+	auto const vt = std::vector<graph::value_type>{{1, 2, 1}, {2, 3, 1}, {3, 4, 1}, {5, 1, 1}};
+	auto const g = graph(vt.begin(), vt.end());
+	auto t = gdwg::traversal(g);
+	CHECK(t.reachable(1, 4));
+	CHECK(t.reachable(1, 1));
+	CHECK(t.reachable(1, 1, 0));
+	CHECK(!t.reachable(1, 2, 0));
+	CHECK(!t.reachable(1, 4, 2));
+	CHECK(t.reachable(1, 4, 3));
+	CHECK(!t.reachable(4, 1));
+	CHECK(!t.reachable(1, 5));
+	CHECK(t.reachable_from(4) == std::vector<int>{4});
+	// a search that ends at its source leaves nothing behind for the next one
+	CHECK(t.reachable(1, 1));
+	CHECK(t.reachable_from(5) == std::vector<int>{1, 2, 3, 4, 5});
+	CHECK_THROWS_WITH(t.reachable(1, 6),
+	                  "Cannot call gdwg::traversal<N, E>::reachable if src or dst node don't exist "
+	                  "in the graph");
+	CHECK_THROWS_WITH(t.reachable(6, 1),
+	                  "Cannot call gdwg::traversal<N, E>::reachable if src or dst node don't exist "
+	                  "in the graph");
+}
+
+TEST_CASE("traversal: reachable_from agrees with connections, serial and parallel") {
+	// sparse graphs stay top-down, dense ones switch to bottom-up after a level or two
+	auto const shapes = std::vector<std::pair<int, int>>{{300, 250}, {300, 600}, {2000, 30000}};
+	for (auto const& [n, count] : shapes) {
+		auto g = random_graph<graph>(n, count, static_cast<unsigned>(n + count));
+		auto const flat = random_graph<flat_graph>(n, count, static_cast<unsigned>(n + count));
+		// erased nodes leave unused ids behind
+		for (auto const victim : {5, 77, 130}) {
+			g.erase_node(victim);
+		}
+		auto t = gdwg::traversal(g);
+		auto flat_t = gdwg::traversal(flat);
+		for (auto src = 0; src < n; src += 37) {
+			if (!g.is_node(src)) {
+				continue;
+			}
+			auto const expected = reference_reachable(g, src);
+			CHECK(t.reachable_from(src) == expected);
+			CHECK(gdwg::reachable_from(std::execution::par, t, src) == expected);
+			CHECK(gdwg::reachable_from(std::execution::seq, t, src) == expected);
+			CHECK(gdwg::reachable_from(std::execution::par, flat_t, src)
+			      == reference_reachable(flat, src));
+			for (auto const dst : {0, 1, n - 1}) {
+				if (g.is_node(dst)) {
+					auto const found = std::binary_search(expected.begin(), expected.end(), dst);
+					CHECK(t.reachable(src, dst) == found);
+				}
+			}
+		}
+	}
+	auto const empty = graph{1};
+	auto t = gdwg::traversal(empty);
+	CHECK(gdwg::reachable_from(std::execution::par, t, 1) == std::vector<int>{1});
+	CHECK_THROWS_WITH(gdwg::reachable_from(std::execution::par, t, 2),
+	                  "Cannot call gdwg::traversal<N, E>::reachable_from if src doesn't exist in "
+	                  "the graph");
+}